@@ -16,7 +16,14 @@
 #define DR_MP3_IMPLEMENTATION
 #include "dr_mp3.h"
 
+#if defined(WITH_OPUS)
+#include <opusfile.h>
+#endif
+
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <future>
 
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -24,6 +31,89 @@ using namespace yarp::dev;
 
 YARP_LOG_COMPONENT(TTSDEVICE, "yarp.ttsDevice", yarp::os::Log::TraceType);
 
+// Frames decoded between two checks of the cancellation of the synthesis
+constexpr drmp3_uint64 decodeChunkFrames = 4096;
+// Decoding buffers kept by the device, enough for about 30 s of mono audio at 24 kHz
+constexpr size_t maxPooledPcmChunks = 192;
+// Format of the pcm responses of the service, also used by its wav responses
+constexpr uint32_t pcmSampleRate = 24000;
+constexpr uint32_t pcmChannels = 1;
+// Largest chunk of a wav header (fmt, LIST...) accepted before the samples
+constexpr uint32_t maxWavChunkSize = 65536;
+
+namespace {
+// drmp3 read callback, it blocks until the data is downloaded
+size_t readStream(void* userData, void* buffer, size_t bytes)
+{
+    return static_cast<azureopenai::StreamingBody*>(userData)->read(static_cast<char*>(buffer), bytes);
+}
+
+#if defined(WITH_OPUS)
+// opusfile read callback, the stream cannot seek
+int readOpusStream(void* stream, unsigned char* buffer, int bytes)
+{
+    return static_cast<int>(static_cast<azureopenai::StreamingBody*>(stream)->read(reinterpret_cast<char*>(buffer), static_cast<size_t>(bytes)));
+}
+#endif
+
+// The quota of the service counts characters, not the bytes of their UTF-8 encoding
+size_t countCodePoints(const std::string& text)
+{
+    return static_cast<size_t>(std::count_if(text.begin(), text.end(), [](unsigned char c) { return (c & 0xC0) != 0x80; }));
+}
+
+uint32_t readLittleEndian(const unsigned char* data, size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Read the header of a wav stream, up to the beginning of the samples
+bool readWavHeader(azureopenai::StreamingBody& stream, uint32_t& channels, uint32_t& sampleRate)
+{
+    unsigned char riff[12];
+    if (stream.read(reinterpret_cast<char*>(riff), sizeof(riff)) != sizeof(riff)
+        || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool format = false;
+    while (true) {
+        unsigned char chunk[8];
+        if (stream.read(reinterpret_cast<char*>(chunk), sizeof(chunk)) != sizeof(chunk)) {
+            return false;
+        }
+        // The size of the data chunk is not reliable when the wav is streamed
+        if (std::memcmp(chunk, "data", 4) == 0) {
+            return format;
+        }
+        // The chunks are padded to an even size
+        uint32_t size = readLittleEndian(chunk + 4, 4);
+        if (size > maxWavChunkSize) {
+            return false;
+        }
+        std::string body(size + (size & 1), '\0');
+        if (stream.read(body.data(), body.size()) != body.size()) {
+            return false;
+        }
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            const auto* fmt = reinterpret_cast<const unsigned char*>(body.data());
+            uint32_t encoding = readLittleEndian(fmt, 2);
+            uint32_t bitsPerSample = readLittleEndian(fmt + 14, 2);
+            channels = readLittleEndian(fmt + 2, 2);
+            sampleRate = readLittleEndian(fmt + 4, 4);
+            if (encoding != 1 || bitsPerSample != 16 || channels == 0) {
+                yCError(TTSDEVICE) << "Unsupported wav format" << encoding << "with" << bitsPerSample << "bits per sample";
+                return false;
+            }
+            format = true;
+        }
+    }
+}
+} // namespace
+
 
 TtsDevice::TtsDevice()
 {
@@ -33,31 +123,79 @@ TtsDevice::TtsDevice()
 bool TtsDevice::open(yarp::os::Searchable &config)
 {
     if (!parseParams(config))  { return false; }
-    if(std::getenv(m_ENVS_api_key_name.c_str()) == nullptr)
     {
-        yCError(TTSDEVICE) << "Environment variable" << m_ENVS_api_key_name << "not set";
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_closing = false;
+    }
+
+    azureopenai::ClientOptions options;
+    options.endPointEnv = m_ENVS_end_point_name;
+    options.deploymentIdEnv = m_ENVS_deployment_id_name;
+    options.apiKeyEnv = m_ENVS_api_key_name;
+    options.apiVersionEnv = m_ENVS_api_version_name;
+    options.envSuffixes = m_BALANCER_env_suffixes;
+    options.hedgeDeploymentIdEnv = m_HEDGING_deployment_id_name;
+    options.operation = "audio/speech";
+    options.headers = {"Content-Type: application/json"};
+    options.httpVersion = m_HTTP_http_version;
+    options.transport = m_HTTP_transport;
+    options.fake.latency = m_FAKE_latency;
+    options.fake.bandwidth = m_FAKE_bandwidth;
+    options.fakeResponseFile = m_FAKE_response_file;
+    options.gatewaySocket = m_HTTP_gateway_socket;
+    options.cacheFile = m_HTTP_cache_file;
+    options.prewarm = m_HTTP_prewarm;
+    options.keepAlivePeriod = m_HTTP_keepalive_period;
+    options.timeouts.connect = m_TIMEOUTS_connect;
+    options.timeouts.firstByte = m_TIMEOUTS_first_byte;
+    options.timeouts.lowSpeedLimit = m_TIMEOUTS_low_speed_limit;
+    options.timeouts.lowSpeedTime = m_TIMEOUTS_low_speed_time;
+    options.timeouts.total = m_TIMEOUTS_total;
+    options.deadline = m_TIMEOUTS_deadline;
+    options.ewmaAlpha = m_BALANCER_ewma_alpha;
+    options.exploration = m_BALANCER_exploration;
+    options.breaker.failureThreshold = static_cast<unsigned int>(std::max(m_BREAKER_failure_threshold, 0));
+    options.breaker.cooldown = m_BREAKER_cooldown;
+    options.retry.maxRetries = static_cast<unsigned int>(std::max(m_RETRY_max_retries, 0));
+    options.retry.initialBackoff = m_RETRY_initial_backoff;
+    options.retry.maxBackoff = m_RETRY_max_backoff;
+    options.retry.budget = m_RETRY_budget;
+    options.requestsPerMinute = m_LIMITS_requests_per_minute;
+    options.unitsPerMinute = m_LIMITS_characters_per_minute;
+    options.burst = m_LIMITS_burst;
+    options.concurrency.enabled = m_LIMITS_adaptive_concurrency;
+    options.concurrency.maxLimit = static_cast<size_t>(std::max(m_LIMITS_max_concurrency, 1));
+    options.concurrency.latencyTolerance = m_LIMITS_latency_tolerance;
+    options.hedging.enabled = m_HEDGING_enabled;
+    options.hedging.quantile = m_HEDGING_percentile;
+    options.hedging.minDelay = m_HEDGING_min_delay;
+    options.hedging.defaultDelay = m_HEDGING_default_delay;
+    if (std::find(RESPONSE_FORMATS.begin(), RESPONSE_FORMATS.end(), m_AUDIO_response_format) == RESPONSE_FORMATS.end()) {
+        yCError(TTSDEVICE) << "Invalid response format" << m_AUDIO_response_format;
         return false;
     }
-    if(std::getenv(m_ENVS_end_point_name.c_str()) == nullptr)
-    {
-        yCError(TTSDEVICE) << "Environment variable" << m_ENVS_end_point_name << "not set";
+    if (m_HTTP_transport == "fake" && m_AUDIO_response_format == "opus" && m_FAKE_response_file.empty()) {
+        yCError(TTSDEVICE) << "The fake transport has no canned Opus speech, set FAKE::response_file to an Ogg Opus file";
         return false;
     }
-    if(std::getenv(m_ENVS_deployment_id_name.c_str()) == nullptr)
-    {
-        yCError(TTSDEVICE) << "Environment variable" << m_ENVS_deployment_id_name << "not set";
+#if !defined(WITH_OPUS)
+    if (m_AUDIO_response_format == "opus") {
+        yCError(TTSDEVICE) << "The device was built without Opus support (libopusfile)";
         return false;
     }
-    if(std::getenv(m_ENVS_api_version_name.c_str()) == nullptr)
-    {
-        yCError(TTSDEVICE) << "Environment variable" << m_ENVS_api_version_name << "not set";
+#endif
+    if (!m_client.open(options)) {
         return false;
     }
-    m_apiKey = std::getenv(m_ENVS_api_key_name.c_str());
-    std::string endpoint = std::getenv(m_ENVS_end_point_name.c_str());
-    std::string deployment_id = std::getenv(m_ENVS_deployment_id_name.c_str());
-    std::string api_version = std::getenv(m_ENVS_api_version_name.c_str());
-    m_url = endpoint + "/openai/deployments/" + deployment_id + "/audio/speech?api-version=" + api_version;
+
+    if (!m_BARGEIN_rpc_port_name.empty()) {
+        m_rpcPort.setReader(*this);
+        if (!m_rpcPort.open(m_BARGEIN_rpc_port_name)) {
+            yCError(TTSDEVICE) << "Unable to open the port" << m_BARGEIN_rpc_port_name;
+            m_client.close();
+            return false;
+        }
+    }
 
     yCInfo(TTSDEVICE) << "Open";
     return true;
@@ -65,6 +203,19 @@ bool TtsDevice::open(yarp::os::Searchable &config)
 
 bool TtsDevice::close()
 {
+    m_rpcPort.interrupt();
+    m_rpcPort.close();
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_closing = true;
+    }
+    _cancelInFlight();
+    {
+        // The cancelled calls still decode and release their buffers
+        std::unique_lock<std::mutex> lock(m_inFlightMutex);
+        m_callsDone.wait(lock, [this] { return m_calls == 0; });
+    }
+    m_client.close();
     yCInfo(TTSDEVICE) << "Close";
     return true;
 }
@@ -129,72 +280,321 @@ ReturnValue TtsDevice::getPitch(double& pitch)
 
 ReturnValue TtsDevice::synthesize(const std::string& text, yarp::sig::Sound& sound)
 {
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        yCError(TTSDEVICE) << "Failed to initialize cURL";
+    if (m_BARGEIN_cancel_previous && _cancelInFlight() > 0) {
+        yCInfo(TTSDEVICE) << "Previous synthesis cancelled";
+    }
+    auto token = _beginCall();
+    if (!token) {
+        yCError(TTSDEVICE) << "The device is closing";
         return ReturnValue::return_code::return_value_error_generic;
     }
+    ReturnValue ret = _synthesize(text, sound, token);
+    _endCall(token);
+    return ret;
+}
+
+bool TtsDevice::read(yarp::os::ConnectionReader& connection)
+{
+    yarp::os::Bottle command;
+    yarp::os::Bottle reply;
+    if (!command.read(connection)) {
+        return false;
+    }
 
-    std::string payload = "{\"model\": \"tts-1\", \"input\": \"" + _escapeJsonString(text) + "\", \"voice\": \""+ m_voiceName + "\"}";
+    std::string cmd = command.get(0).asString();
+    if (cmd == "cancel") {
+        size_t cancelled = _cancelInFlight();
+        yCInfo(TTSDEVICE) << "Cancelled" << cancelled << "synthesis requests";
+        reply.addVocab32("ok");
+        reply.addInt32(static_cast<int32_t>(cancelled));
+    } else if (cmd == "help") {
+        reply.addVocab32("many");
+        reply.addString("cancel: abort all the synthesis requests in progress, replies with their number");
+    } else {
+        reply.addVocab32("fail");
+        reply.addString("Unknown command " + cmd);
+    }
 
-    std::vector<uint8_t> audioData;
+    yarp::os::ConnectionWriter* writer = connection.getWriter();
+    if (writer != nullptr) {
+        reply.write(*writer);
+    }
+    return true;
+}
 
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, ("api-key: " + m_apiKey).c_str());
-    headers = curl_slist_append(headers, "Content-Type: application/json");
+std::shared_ptr<azureopenai::CancellationToken> TtsDevice::_beginCall()
+{
+    auto token = std::make_shared<azureopenai::CancellationToken>();
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    if (m_closing) {
+        return nullptr;
+    }
+    m_inFlight.insert(token);
+    ++m_calls;
+    return token;
+}
 
-    curl_easy_setopt(curl, CURLOPT_URL, m_url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POST, 1);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &audioData);
+void TtsDevice::_endCall(const std::shared_ptr<azureopenai::CancellationToken>& token)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_inFlight.erase(token);
+        --m_calls;
+    }
+    m_callsDone.notify_all();
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+size_t TtsDevice::_cancelInFlight()
+{
+    std::set<std::shared_ptr<azureopenai::CancellationToken>> inFlight;
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        inFlight.swap(m_inFlight);
+    }
+    for (const auto& token : inFlight) {
+        token->cancel();
+    }
+    return inFlight.size();
+}
 
-    if (res != CURLE_OK) {
-        yCError(TTSDEVICE) << "cURL request failed: " << curl_easy_strerror(res);
+ReturnValue TtsDevice::_synthesize(const std::string& text, yarp::sig::Sound& sound, const std::shared_ptr<azureopenai::CancellationToken>& token)
+{
+    std::string payload = "{\"model\": \"tts-1\", \"input\": \"" + _escapeJsonString(text) + "\", \"voice\": \""+ m_voiceName + "\", \"response_format\": \"" + m_AUDIO_response_format + "\"}";
+
+    azureopenai::HttpRequest request = m_client.newRequest();
+    request.cancellation = token;
+    request.quotaUnits = static_cast<double>(countCodePoints(text));
+    request.body = std::move(payload);
+
+    // The audio is decoded while it is downloaded, so that it is ready almost
+    // as soon as the last byte arrives
+    auto stream = std::make_shared<azureopenai::StreamingBody>();
+    request.stream = stream;
+    DecodedAudio audio;
+    std::future<bool> decoding = std::async(std::launch::async, [this, &stream, &token, &audio]() { return _decode(*stream, *token, audio); });
+
+    azureopenai::HttpResponse response = m_client.perform(std::move(request));
+    stream->close();
+    bool decoded = decoding.get();
+
+    if (token->isCancelled()) {
+        yCInfo(TTSDEVICE) << "Synthesis cancelled";
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    if (response.deadlineExceeded) {
+        yCError(TTSDEVICE) << "Synthesis abandoned, its deadline expired";
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    if (response.result != CURLE_OK) {
+        yCError(TTSDEVICE) << "cURL request failed: " << curl_easy_strerror(response.result);
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    if (!response.ok()) {
+        yCError(TTSDEVICE) << "Synthesis request failed with HTTP status" << response.status << ":" << response.body;
         return ReturnValue::return_code::return_value_error_generic;
     }
 
-    yCInfo(TTSDEVICE) << "Downloaded MP3 data: " << audioData.size() << " bytes";
-
-    // Decode MP3 using dr_mp3
-    drmp3 mp3;
-    if (!drmp3_init_memory(&mp3, audioData.data(), audioData.size(), NULL)) {
-        yCError(TTSDEVICE) << "Failed to decode MP3";
+    yCInfo(TTSDEVICE) << "Downloaded" << m_AUDIO_response_format << "data: " << stream->size() << " bytes";
+    if (!decoded) {
+        yCError(TTSDEVICE) << "Failed to decode the" << m_AUDIO_response_format << "data";
         return ReturnValue::return_code::return_value_error_generic;
     }
 
-    drmp3_uint64 totalFrames = drmp3_get_pcm_frame_count(&mp3);
-    std::vector<int16_t> pcmData(totalFrames * mp3.channels);
+    yCInfo(TTSDEVICE) << "Decoded " << audio.frames << " frames, channels: " << audio.channels;
 
-    drmp3_uint64 samplesRead = drmp3_read_pcm_frames_s16(&mp3, totalFrames, pcmData.data());
-    drmp3_uninit(&mp3);
+    _copyToSound(audio, sound);
+    _recyclePcm(audio);
 
-    pcmData.resize(samplesRead * mp3.channels);
+    return ReturnValue_ok;
+}
+
+bool TtsDevice::_decode(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio)
+{
+    if (m_AUDIO_response_format == "mp3") {
+        return _decodeMp3(stream, token, audio);
+    }
+#if defined(WITH_OPUS)
+    if (m_AUDIO_response_format == "opus") {
+        return _decodeOpus(stream, token, audio);
+    }
+#endif
+    return _decodePcm(stream, token, audio);
+}
 
-    yCInfo(TTSDEVICE) << "Decoded " << samplesRead << " frames, channels: " << mp3.channels;
+bool TtsDevice::_decodePcm(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio)
+{
+    // The samples are little endian, like the hosts the device runs on, and
+    // are read straight into the chunks
+    while (true) {
+        _recyclePcm(audio);
+        audio.channels = pcmChannels;
+        audio.sampleRate = pcmSampleRate;
+        bool initialized = m_AUDIO_response_format != "wav" || readWavHeader(stream, audio.channels, audio.sampleRate);
+        if (initialized) {
+            size_t frameSize = audio.channels * sizeof(int16_t);
+            while (!token.isCancelled()) {
+                audio.chunks.push_back(_takePcmChunk(decodeChunkFrames * audio.channels));
+                size_t read = stream.read(reinterpret_cast<char*>(audio.chunks.back().data()), decodeChunkFrames * frameSize);
+                audio.frames += read / frameSize;
+                if (read < decodeChunkFrames * frameSize) {
+                    break;
+                }
+            }
+        }
+        if (!stream.restarted()) {
+            return initialized && stream.isComplete();
+        }
+        // The download failed half-way and the request is being retried, read the new body
+    }
+}
 
+bool TtsDevice::_decodeMp3(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio)
+{
+    // A single pass: the frames are decoded into fixed size chunks, so the
+    // buffer grows without copying what is already decoded
+    while (true) {
+        _recyclePcm(audio);
+        drmp3 mp3;
+        bool initialized = drmp3_init(&mp3, readStream, nullptr, nullptr, nullptr, &stream, nullptr);
+        if (initialized) {
+            audio.channels = mp3.channels;
+            audio.sampleRate = mp3.sampleRate;
+            // Decoded chunk by chunk, to stop early if the synthesis is cancelled
+            while (!token.isCancelled()) {
+                audio.chunks.push_back(_takePcmChunk(decodeChunkFrames * mp3.channels));
+                drmp3_uint64 read = drmp3_read_pcm_frames_s16(&mp3, decodeChunkFrames, audio.chunks.back().data());
+                audio.frames += read;
+                if (read < decodeChunkFrames) {
+                    break;
+                }
+            }
+            drmp3_uninit(&mp3);
+        }
+        if (!stream.restarted()) {
+            return initialized && stream.isComplete();
+        }
+        // The download failed half-way and the request is being retried, decode the new body
+    }
+}
+
+#if defined(WITH_OPUS)
+bool TtsDevice::_decodeOpus(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio)
+{
+    // Ogg Opus, decoded page by page as it is downloaded
+    const OpusFileCallbacks callbacks{readOpusStream, nullptr, nullptr, nullptr};
+    while (true) {
+        _recyclePcm(audio);
+        bool decoded = false;
+        int error = 0;
+        OggOpusFile* opus = op_open_callbacks(&stream, &callbacks, nullptr, 0, &error);
+        if (opus != nullptr) {
+            // Opus is always decoded at 48 kHz
+            audio.channels = static_cast<uint32_t>(op_channel_count(opus, -1));
+            audio.sampleRate = 48000;
+            decoded = true;
+            bool end = false;
+            while (!end && decoded && !token.isCancelled()) {
+                audio.chunks.push_back(_takePcmChunk(decodeChunkFrames * audio.channels));
+                int16_t* chunk = audio.chunks.back().data();
+                size_t filled = 0;
+                while (filled < decodeChunkFrames) {
+                    int link = 0;
+                    int read = op_read(opus, chunk + filled * audio.channels, static_cast<int>((decodeChunkFrames - filled) * audio.channels), &link);
+                    if (read == OP_HOLE) {
+                        // Some data is missing, the decoding goes on after the gap
+                        continue;
+                    }
+                    if (read <= 0 || static_cast<uint32_t>(op_channel_count(opus, link)) != audio.channels) {
+                        end = true;
+                        decoded = read == 0;
+                        break;
+                    }
+                    filled += static_cast<size_t>(read);
+                }
+                audio.frames += filled;
+            }
+            op_free(opus);
+        }
+        if (!stream.restarted()) {
+            return decoded && stream.isComplete();
+        }
+        // The download failed half-way and the request is being retried, decode the new body
+    }
+}
+#endif
+
+void TtsDevice::_copyToSound(const DecodedAudio& audio, yarp::sig::Sound& sound)
+{
     sound.clear();
-    sound.resize(samplesRead, mp3.channels);
-    sound.setFrequency(mp3.sampleRate);
+    sound.resize(audio.frames, audio.channels);
+    sound.setFrequency(audio.sampleRate);
+
+    // The Sound stores one plane of 16 bit samples per channel: if it does,
+    // the chunks are copied into it in bulk, otherwise sample by sample
+    auto* raw = reinterpret_cast<int16_t*>(sound.getRawData());
+    bool planar = raw != nullptr
+                  && sound.getBytesPerSample() == sizeof(int16_t)
+                  && sound.getRawDataSize() == audio.frames * audio.channels * sizeof(int16_t);
+    if (planar && audio.frames > 1) {
+        // Check the layout (and the byte order) where planar and interleaved differ
+        constexpr int16_t probe = 0x0102;
+        sound.set(probe, 0, audio.channels - 1);
+        planar = raw[(audio.channels - 1) * audio.frames] == probe;
+        sound.set(0, 0, audio.channels - 1);
+    }
 
-    for (size_t i = 0; i < samplesRead; ++i) {
-        for (uint32_t ch = 0; ch < mp3.channels; ++ch) {
-            sound.set(pcmData[i * mp3.channels + ch], i, ch);
+    for (size_t c = 0; c < audio.chunks.size(); ++c) {
+        size_t first = c * decodeChunkFrames;
+        size_t frames = std::min<size_t>(decodeChunkFrames, audio.frames - first);
+        const int16_t* chunk = audio.chunks[c].data();
+        if (!planar) {
+            for (size_t i = 0; i < frames; ++i) {
+                for (uint32_t ch = 0; ch < audio.channels; ++ch) {
+                    sound.set(chunk[i * audio.channels + ch], first + i, ch);
+                }
+            }
+        } else if (audio.channels == 1) {
+            std::memcpy(raw + first, chunk, frames * sizeof(int16_t));
+        } else {
+            // De-interleaved one channel at a time, a loop the compiler vectorizes
+            for (uint32_t ch = 0; ch < audio.channels; ++ch) {
+                int16_t* plane = raw + ch * audio.frames + first;
+                const int16_t* source = chunk + ch;
+                for (size_t i = 0; i < frames; ++i) {
+                    plane[i] = source[i * audio.channels];
+                }
+            }
         }
     }
+}
 
-    return ReturnValue_ok;
+std::vector<int16_t> TtsDevice::_takePcmChunk(size_t samples)
+{
+    std::vector<int16_t> chunk;
+    {
+        std::lock_guard<std::mutex> lock(m_pcmPoolMutex);
+        if (!m_pcmPool.empty()) {
+            chunk = std::move(m_pcmPool.back());
+            m_pcmPool.pop_back();
+        }
+    }
+    chunk.resize(samples);
+    return chunk;
 }
 
-size_t TtsDevice::_writeCallback(void *contents, size_t size, size_t nmemb, std::vector<uint8_t> *output) {
-    size_t totalSize = size * nmemb;
-    output->insert(output->end(), (uint8_t *)contents, (uint8_t *)contents + totalSize);
-    return totalSize;
+void TtsDevice::_recyclePcm(DecodedAudio& audio)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pcmPoolMutex);
+        for (auto& chunk : audio.chunks) {
+            if (m_pcmPool.size() >= maxPooledPcmChunks) {
+                break;
+            }
+            m_pcmPool.push_back(std::move(chunk));
+        }
+    }
+    audio.chunks.clear();
+    audio.frames = 0;
 }
 
 std::string TtsDevice::_escapeJsonString(const std::string &input) {
@@ -11,11 +11,19 @@
 #include <curl/curl.h>
 #include <vector>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
 #include <yarp/os/all.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/RpcServer.h>
 #include <yarp/sig/Sound.h>
 #include <iomanip> // for std::setw, std::hex, std::setfill
 
 #include "TtsDevice_ParamsParser.h"
+#include "AzureOpenAIClient.h"
+#include "CancellationToken.h"
+#include "StreamingBody.h"
 
 /**
  *  @ingroup dev_impl_other
@@ -26,6 +34,9 @@
  *
  *  Parameters required by this device are described in class TtsDevice_ParamsParser
  *
+ *  If BARGEIN::rpc_port_name is set, the device opens an RPC port accepting the
+ *  `cancel` command, which aborts all the synthesize() calls in progress.
+ *
  */
 
 const std::vector<std::string> VOICES{
@@ -36,9 +47,16 @@ const std::vector<std::string> VOICES{
     "onyx",
     "shimmer"};
 
+const std::vector<std::string> RESPONSE_FORMATS{
+    "mp3",
+    "pcm",
+    "wav",
+    "opus"};
+
 class TtsDevice :
         public yarp::dev::DeviceDriver,
         public yarp::dev::ISpeechSynthesizer,
+        public yarp::os::PortReader,
         public TtsDevice_ParamsParser
 {
 public:
@@ -64,12 +82,44 @@ public:
     yarp::dev::ReturnValue getPitch(double& pitch) override;
     yarp::dev::ReturnValue synthesize(const std::string& text, yarp::sig::Sound& sound) override;
 
+    // PortReader (barge-in RPC commands)
+    bool read(yarp::os::ConnectionReader& connection) override;
+
 private:
+    struct DecodedAudio
+    {
+        // Interleaved samples, in chunks of the same size, the last one partially filled
+        std::vector<std::vector<int16_t>> chunks;
+        size_t frames{0};
+        uint32_t channels{0};
+        uint32_t sampleRate{0};
+    };
+
     std::string m_voiceName{VOICES[3]};
-    std::string m_url;
-    std::string m_apiKey;
-    struct curl_slist *headers{nullptr};
-    static size_t _writeCallback(void *contents, size_t size, size_t nmemb, std::vector<uint8_t> *output);
+    azureopenai::AzureOpenAIClient m_client;
+    std::mutex m_inFlightMutex;
+    std::set<std::shared_ptr<azureopenai::CancellationToken>> m_inFlight;
+    // synthesize() calls in progress, close() waits for them
+    std::condition_variable m_callsDone;
+    size_t m_calls{0};
+    bool m_closing{false};
+    // Decoding buffers kept for the next calls
+    std::mutex m_pcmPoolMutex;
+    std::vector<std::vector<int16_t>> m_pcmPool;
+    yarp::os::RpcServer m_rpcPort;
+    std::shared_ptr<azureopenai::CancellationToken> _beginCall();
+    void _endCall(const std::shared_ptr<azureopenai::CancellationToken>& token);
+    size_t _cancelInFlight();
+    yarp::dev::ReturnValue _synthesize(const std::string& text, yarp::sig::Sound& sound, const std::shared_ptr<azureopenai::CancellationToken>& token);
+    bool _decode(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio);
+    bool _decodePcm(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio);
+    bool _decodeMp3(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio);
+#if defined(WITH_OPUS)
+    bool _decodeOpus(azureopenai::StreamingBody& stream, const azureopenai::CancellationToken& token, DecodedAudio& audio);
+#endif
+    void _copyToSound(const DecodedAudio& audio, yarp::sig::Sound& sound);
+    std::vector<int16_t> _takePcmChunk(size_t samples);
+    void _recyclePcm(DecodedAudio& audio);
     std::string _escapeJsonString(const std::string &input);
     bool _voiceNameIsValid(const std::string& voice_name);
 };
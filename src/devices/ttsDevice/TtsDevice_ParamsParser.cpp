@@ -8,7 +8,7 @@
 // This is an automatically generated file. Please do not edit it.
 // It will be re-generated if the cmake flag ALLOW_DEVICE_PARAM_PARSER_GERNERATION is ON.
 
-// Generated on: Wed Aug 27 17:37:40 2025
+// Generated on: Sat Oct 17 19:20:00 2026
 
 
 #include "TtsDevice_ParamsParser.h"
@@ -28,16 +28,59 @@ TtsDevice_ParamsParser::TtsDevice_ParamsParser()
 std::vector<std::string> TtsDevice_ParamsParser::getListOfParams() const
 {
     std::vector<std::string> params;
+    params.push_back("AUDIO::response_format");
     params.push_back("ENVS::end_point_name");
     params.push_back("ENVS::deployment_id_name");
     params.push_back("ENVS::api_key_name");
     params.push_back("ENVS::api_version_name");
+    params.push_back("HTTP::prewarm");
+    params.push_back("HTTP::keepalive_period");
+    params.push_back("HTTP::http_version");
+    params.push_back("HTTP::transport");
+    params.push_back("HTTP::gateway_socket");
+    params.push_back("HTTP::cache_file");
+    params.push_back("HEDGING::enabled");
+    params.push_back("HEDGING::percentile");
+    params.push_back("HEDGING::min_delay");
+    params.push_back("HEDGING::default_delay");
+    params.push_back("HEDGING::deployment_id_name");
+    params.push_back("BALANCER::env_suffixes");
+    params.push_back("BALANCER::ewma_alpha");
+    params.push_back("BALANCER::exploration");
+    params.push_back("RETRY::max_retries");
+    params.push_back("RETRY::initial_backoff");
+    params.push_back("RETRY::max_backoff");
+    params.push_back("RETRY::budget");
+    params.push_back("LIMITS::requests_per_minute");
+    params.push_back("LIMITS::characters_per_minute");
+    params.push_back("LIMITS::burst");
+    params.push_back("LIMITS::adaptive_concurrency");
+    params.push_back("LIMITS::max_concurrency");
+    params.push_back("LIMITS::latency_tolerance");
+    params.push_back("BREAKER::failure_threshold");
+    params.push_back("BREAKER::cooldown");
+    params.push_back("TIMEOUTS::connect");
+    params.push_back("TIMEOUTS::first_byte");
+    params.push_back("TIMEOUTS::low_speed_limit");
+    params.push_back("TIMEOUTS::low_speed_time");
+    params.push_back("TIMEOUTS::total");
+    params.push_back("TIMEOUTS::deadline");
+    params.push_back("BARGEIN::cancel_previous");
+    params.push_back("BARGEIN::rpc_port_name");
+    params.push_back("FAKE::latency");
+    params.push_back("FAKE::bandwidth");
+    params.push_back("FAKE::response_file");
     return params;
 }
 
 
 bool TtsDevice_ParamsParser::getParamValue(const std::string& paramName, std::string& paramValue) const
 {
+    if (paramName =="AUDIO::response_format")
+    {
+        paramValue = m_AUDIO_response_format;
+        return true;
+    }
     if (paramName =="ENVS::end_point_name")
     {
         paramValue = m_ENVS_end_point_name;
@@ -58,6 +101,194 @@ bool TtsDevice_ParamsParser::getParamValue(const std::string& paramName, std::st
         paramValue = m_ENVS_api_version_name;
         return true;
     }
+    if (paramName =="HTTP::prewarm")
+    {
+        if (m_HTTP_prewarm==false) paramValue = "false";
+        else paramValue = "true";
+        return true;
+    }
+    if (paramName =="HTTP::keepalive_period")
+    {
+        paramValue = std::to_string(m_HTTP_keepalive_period);
+        return true;
+    }
+    if (paramName =="HTTP::http_version")
+    {
+        paramValue = m_HTTP_http_version;
+        return true;
+    }
+    if (paramName =="HTTP::transport")
+    {
+        paramValue = m_HTTP_transport;
+        return true;
+    }
+    if (paramName =="HTTP::gateway_socket")
+    {
+        paramValue = m_HTTP_gateway_socket;
+        return true;
+    }
+    if (paramName =="HTTP::cache_file")
+    {
+        paramValue = m_HTTP_cache_file;
+        return true;
+    }
+    if (paramName =="HEDGING::enabled")
+    {
+        if (m_HEDGING_enabled==false) paramValue = "false";
+        else paramValue = "true";
+        return true;
+    }
+    if (paramName =="HEDGING::percentile")
+    {
+        paramValue = std::to_string(m_HEDGING_percentile);
+        return true;
+    }
+    if (paramName =="HEDGING::min_delay")
+    {
+        paramValue = std::to_string(m_HEDGING_min_delay);
+        return true;
+    }
+    if (paramName =="HEDGING::default_delay")
+    {
+        paramValue = std::to_string(m_HEDGING_default_delay);
+        return true;
+    }
+    if (paramName =="HEDGING::deployment_id_name")
+    {
+        paramValue = m_HEDGING_deployment_id_name;
+        return true;
+    }
+    if (paramName =="BALANCER::env_suffixes")
+    {
+        return false;
+    }
+    if (paramName =="BALANCER::ewma_alpha")
+    {
+        paramValue = std::to_string(m_BALANCER_ewma_alpha);
+        return true;
+    }
+    if (paramName =="BALANCER::exploration")
+    {
+        paramValue = std::to_string(m_BALANCER_exploration);
+        return true;
+    }
+    if (paramName =="RETRY::max_retries")
+    {
+        paramValue = std::to_string(m_RETRY_max_retries);
+        return true;
+    }
+    if (paramName =="RETRY::initial_backoff")
+    {
+        paramValue = std::to_string(m_RETRY_initial_backoff);
+        return true;
+    }
+    if (paramName =="RETRY::max_backoff")
+    {
+        paramValue = std::to_string(m_RETRY_max_backoff);
+        return true;
+    }
+    if (paramName =="RETRY::budget")
+    {
+        paramValue = std::to_string(m_RETRY_budget);
+        return true;
+    }
+    if (paramName =="LIMITS::requests_per_minute")
+    {
+        paramValue = std::to_string(m_LIMITS_requests_per_minute);
+        return true;
+    }
+    if (paramName =="LIMITS::characters_per_minute")
+    {
+        paramValue = std::to_string(m_LIMITS_characters_per_minute);
+        return true;
+    }
+    if (paramName =="LIMITS::burst")
+    {
+        paramValue = std::to_string(m_LIMITS_burst);
+        return true;
+    }
+    if (paramName =="LIMITS::adaptive_concurrency")
+    {
+        if (m_LIMITS_adaptive_concurrency==false) paramValue = "false";
+        else paramValue = "true";
+        return true;
+    }
+    if (paramName =="LIMITS::max_concurrency")
+    {
+        paramValue = std::to_string(m_LIMITS_max_concurrency);
+        return true;
+    }
+    if (paramName =="LIMITS::latency_tolerance")
+    {
+        paramValue = std::to_string(m_LIMITS_latency_tolerance);
+        return true;
+    }
+    if (paramName =="BREAKER::failure_threshold")
+    {
+        paramValue = std::to_string(m_BREAKER_failure_threshold);
+        return true;
+    }
+    if (paramName =="BREAKER::cooldown")
+    {
+        paramValue = std::to_string(m_BREAKER_cooldown);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::connect")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_connect);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::first_byte")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_first_byte);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::low_speed_limit")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_low_speed_limit);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::low_speed_time")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_low_speed_time);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::total")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_total);
+        return true;
+    }
+    if (paramName =="TIMEOUTS::deadline")
+    {
+        paramValue = std::to_string(m_TIMEOUTS_deadline);
+        return true;
+    }
+    if (paramName =="BARGEIN::cancel_previous")
+    {
+        if (m_BARGEIN_cancel_previous==false) paramValue = "false";
+        else paramValue = "true";
+        return true;
+    }
+    if (paramName =="BARGEIN::rpc_port_name")
+    {
+        paramValue = m_BARGEIN_rpc_port_name;
+        return true;
+    }
+    if (paramName =="FAKE::latency")
+    {
+        paramValue = std::to_string(m_FAKE_latency);
+        return true;
+    }
+    if (paramName =="FAKE::bandwidth")
+    {
+        paramValue = std::to_string(m_FAKE_bandwidth);
+        return true;
+    }
+    if (paramName =="FAKE::response_file")
+    {
+        paramValue = m_FAKE_response_file;
+        return true;
+    }
 
     yError() <<"parameter '" << paramName << "' was not found";
     return false;
@@ -85,6 +316,22 @@ bool      TtsDevice_ParamsParser::parseParams(const yarp::os::Searchable & confi
 
     m_provided_configuration = config.toString();
     yarp::os::Property prop_check(m_provided_configuration.c_str());
+    //Parser of parameter AUDIO::response_format
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("AUDIO");
+        if (sectionp.check("response_format"))
+        {
+            m_AUDIO_response_format = sectionp.find("response_format").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'AUDIO::response_format' using value:" << m_AUDIO_response_format;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'AUDIO::response_format' using DEFAULT value:" << m_AUDIO_response_format;
+        }
+        prop_check.unput("AUDIO::response_format");
+    }
+
     //Parser of parameter ENVS::end_point_name
     {
         yarp::os::Bottle sectionp;
@@ -149,6 +396,613 @@ bool      TtsDevice_ParamsParser::parseParams(const yarp::os::Searchable & confi
         prop_check.unput("ENVS::api_version_name");
     }
 
+    //Parser of parameter HTTP::prewarm
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("prewarm"))
+        {
+            m_HTTP_prewarm = sectionp.find("prewarm").asBool();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::prewarm' using value:" << m_HTTP_prewarm;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::prewarm' using DEFAULT value:" << m_HTTP_prewarm;
+        }
+        prop_check.unput("HTTP::prewarm");
+    }
+
+    //Parser of parameter HTTP::keepalive_period
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("keepalive_period"))
+        {
+            m_HTTP_keepalive_period = sectionp.find("keepalive_period").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::keepalive_period' using value:" << m_HTTP_keepalive_period;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::keepalive_period' using DEFAULT value:" << m_HTTP_keepalive_period;
+        }
+        prop_check.unput("HTTP::keepalive_period");
+    }
+
+    //Parser of parameter HTTP::http_version
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("http_version"))
+        {
+            m_HTTP_http_version = sectionp.find("http_version").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::http_version' using value:" << m_HTTP_http_version;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::http_version' using DEFAULT value:" << m_HTTP_http_version;
+        }
+        prop_check.unput("HTTP::http_version");
+    }
+
+    //Parser of parameter HTTP::transport
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("transport"))
+        {
+            m_HTTP_transport = sectionp.find("transport").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::transport' using value:" << m_HTTP_transport;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::transport' using DEFAULT value:" << m_HTTP_transport;
+        }
+        prop_check.unput("HTTP::transport");
+    }
+
+    //Parser of parameter HTTP::gateway_socket
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("gateway_socket"))
+        {
+            m_HTTP_gateway_socket = sectionp.find("gateway_socket").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::gateway_socket' using value:" << m_HTTP_gateway_socket;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::gateway_socket' using DEFAULT value:" << m_HTTP_gateway_socket;
+        }
+        prop_check.unput("HTTP::gateway_socket");
+    }
+
+    //Parser of parameter HTTP::cache_file
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HTTP");
+        if (sectionp.check("cache_file"))
+        {
+            m_HTTP_cache_file = sectionp.find("cache_file").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::cache_file' using value:" << m_HTTP_cache_file;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HTTP::cache_file' using DEFAULT value:" << m_HTTP_cache_file;
+        }
+        prop_check.unput("HTTP::cache_file");
+    }
+
+    //Parser of parameter HEDGING::enabled
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HEDGING");
+        if (sectionp.check("enabled"))
+        {
+            m_HEDGING_enabled = sectionp.find("enabled").asBool();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::enabled' using value:" << m_HEDGING_enabled;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::enabled' using DEFAULT value:" << m_HEDGING_enabled;
+        }
+        prop_check.unput("HEDGING::enabled");
+    }
+
+    //Parser of parameter HEDGING::percentile
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HEDGING");
+        if (sectionp.check("percentile"))
+        {
+            m_HEDGING_percentile = sectionp.find("percentile").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::percentile' using value:" << m_HEDGING_percentile;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::percentile' using DEFAULT value:" << m_HEDGING_percentile;
+        }
+        prop_check.unput("HEDGING::percentile");
+    }
+
+    //Parser of parameter HEDGING::min_delay
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HEDGING");
+        if (sectionp.check("min_delay"))
+        {
+            m_HEDGING_min_delay = sectionp.find("min_delay").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::min_delay' using value:" << m_HEDGING_min_delay;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::min_delay' using DEFAULT value:" << m_HEDGING_min_delay;
+        }
+        prop_check.unput("HEDGING::min_delay");
+    }
+
+    //Parser of parameter HEDGING::default_delay
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HEDGING");
+        if (sectionp.check("default_delay"))
+        {
+            m_HEDGING_default_delay = sectionp.find("default_delay").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::default_delay' using value:" << m_HEDGING_default_delay;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::default_delay' using DEFAULT value:" << m_HEDGING_default_delay;
+        }
+        prop_check.unput("HEDGING::default_delay");
+    }
+
+    //Parser of parameter HEDGING::deployment_id_name
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("HEDGING");
+        if (sectionp.check("deployment_id_name"))
+        {
+            m_HEDGING_deployment_id_name = sectionp.find("deployment_id_name").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::deployment_id_name' using value:" << m_HEDGING_deployment_id_name;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'HEDGING::deployment_id_name' using DEFAULT value:" << m_HEDGING_deployment_id_name;
+        }
+        prop_check.unput("HEDGING::deployment_id_name");
+    }
+
+    //Parser of parameter BALANCER::env_suffixes
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BALANCER");
+        if (sectionp.check("env_suffixes"))
+        {
+            {
+                m_BALANCER_env_suffixes.clear();
+                yarp::os::Bottle* tempBot = sectionp.find("env_suffixes").asList();
+                if (tempBot)
+                {
+                    std::string tempBots = tempBot->toString();
+                    for (size_t i=0; i<tempBot->size(); i++)
+                    {
+                        m_BALANCER_env_suffixes.push_back(tempBot->get(i).asString());
+                    }
+                }
+                else
+                {
+                     yCError(TtsDeviceParamsCOMPONENT) <<"parameter 'BALANCER::env_suffixes' is not a properly formatted bottle";
+                }
+            }
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::env_suffixes' using value:" << m_BALANCER_env_suffixes.size() << "items";
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::env_suffixes' using DEFAULT value:" << m_BALANCER_env_suffixes.size() << "items";
+        }
+        prop_check.unput("BALANCER::env_suffixes");
+    }
+
+    //Parser of parameter BALANCER::ewma_alpha
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BALANCER");
+        if (sectionp.check("ewma_alpha"))
+        {
+            m_BALANCER_ewma_alpha = sectionp.find("ewma_alpha").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::ewma_alpha' using value:" << m_BALANCER_ewma_alpha;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::ewma_alpha' using DEFAULT value:" << m_BALANCER_ewma_alpha;
+        }
+        prop_check.unput("BALANCER::ewma_alpha");
+    }
+
+    //Parser of parameter BALANCER::exploration
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BALANCER");
+        if (sectionp.check("exploration"))
+        {
+            m_BALANCER_exploration = sectionp.find("exploration").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::exploration' using value:" << m_BALANCER_exploration;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BALANCER::exploration' using DEFAULT value:" << m_BALANCER_exploration;
+        }
+        prop_check.unput("BALANCER::exploration");
+    }
+
+    //Parser of parameter RETRY::max_retries
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("RETRY");
+        if (sectionp.check("max_retries"))
+        {
+            m_RETRY_max_retries = sectionp.find("max_retries").asInt64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::max_retries' using value:" << m_RETRY_max_retries;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::max_retries' using DEFAULT value:" << m_RETRY_max_retries;
+        }
+        prop_check.unput("RETRY::max_retries");
+    }
+
+    //Parser of parameter RETRY::initial_backoff
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("RETRY");
+        if (sectionp.check("initial_backoff"))
+        {
+            m_RETRY_initial_backoff = sectionp.find("initial_backoff").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::initial_backoff' using value:" << m_RETRY_initial_backoff;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::initial_backoff' using DEFAULT value:" << m_RETRY_initial_backoff;
+        }
+        prop_check.unput("RETRY::initial_backoff");
+    }
+
+    //Parser of parameter RETRY::max_backoff
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("RETRY");
+        if (sectionp.check("max_backoff"))
+        {
+            m_RETRY_max_backoff = sectionp.find("max_backoff").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::max_backoff' using value:" << m_RETRY_max_backoff;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::max_backoff' using DEFAULT value:" << m_RETRY_max_backoff;
+        }
+        prop_check.unput("RETRY::max_backoff");
+    }
+
+    //Parser of parameter RETRY::budget
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("RETRY");
+        if (sectionp.check("budget"))
+        {
+            m_RETRY_budget = sectionp.find("budget").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::budget' using value:" << m_RETRY_budget;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'RETRY::budget' using DEFAULT value:" << m_RETRY_budget;
+        }
+        prop_check.unput("RETRY::budget");
+    }
+
+    //Parser of parameter LIMITS::requests_per_minute
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("requests_per_minute"))
+        {
+            m_LIMITS_requests_per_minute = sectionp.find("requests_per_minute").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::requests_per_minute' using value:" << m_LIMITS_requests_per_minute;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::requests_per_minute' using DEFAULT value:" << m_LIMITS_requests_per_minute;
+        }
+        prop_check.unput("LIMITS::requests_per_minute");
+    }
+
+    //Parser of parameter LIMITS::characters_per_minute
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("characters_per_minute"))
+        {
+            m_LIMITS_characters_per_minute = sectionp.find("characters_per_minute").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::characters_per_minute' using value:" << m_LIMITS_characters_per_minute;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::characters_per_minute' using DEFAULT value:" << m_LIMITS_characters_per_minute;
+        }
+        prop_check.unput("LIMITS::characters_per_minute");
+    }
+
+    //Parser of parameter LIMITS::burst
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("burst"))
+        {
+            m_LIMITS_burst = sectionp.find("burst").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::burst' using value:" << m_LIMITS_burst;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::burst' using DEFAULT value:" << m_LIMITS_burst;
+        }
+        prop_check.unput("LIMITS::burst");
+    }
+
+    //Parser of parameter LIMITS::adaptive_concurrency
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("adaptive_concurrency"))
+        {
+            m_LIMITS_adaptive_concurrency = sectionp.find("adaptive_concurrency").asBool();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::adaptive_concurrency' using value:" << m_LIMITS_adaptive_concurrency;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::adaptive_concurrency' using DEFAULT value:" << m_LIMITS_adaptive_concurrency;
+        }
+        prop_check.unput("LIMITS::adaptive_concurrency");
+    }
+
+    //Parser of parameter LIMITS::max_concurrency
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("max_concurrency"))
+        {
+            m_LIMITS_max_concurrency = sectionp.find("max_concurrency").asInt64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::max_concurrency' using value:" << m_LIMITS_max_concurrency;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::max_concurrency' using DEFAULT value:" << m_LIMITS_max_concurrency;
+        }
+        prop_check.unput("LIMITS::max_concurrency");
+    }
+
+    //Parser of parameter LIMITS::latency_tolerance
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("LIMITS");
+        if (sectionp.check("latency_tolerance"))
+        {
+            m_LIMITS_latency_tolerance = sectionp.find("latency_tolerance").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::latency_tolerance' using value:" << m_LIMITS_latency_tolerance;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'LIMITS::latency_tolerance' using DEFAULT value:" << m_LIMITS_latency_tolerance;
+        }
+        prop_check.unput("LIMITS::latency_tolerance");
+    }
+
+    //Parser of parameter BREAKER::failure_threshold
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BREAKER");
+        if (sectionp.check("failure_threshold"))
+        {
+            m_BREAKER_failure_threshold = sectionp.find("failure_threshold").asInt64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BREAKER::failure_threshold' using value:" << m_BREAKER_failure_threshold;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BREAKER::failure_threshold' using DEFAULT value:" << m_BREAKER_failure_threshold;
+        }
+        prop_check.unput("BREAKER::failure_threshold");
+    }
+
+    //Parser of parameter BREAKER::cooldown
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BREAKER");
+        if (sectionp.check("cooldown"))
+        {
+            m_BREAKER_cooldown = sectionp.find("cooldown").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BREAKER::cooldown' using value:" << m_BREAKER_cooldown;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BREAKER::cooldown' using DEFAULT value:" << m_BREAKER_cooldown;
+        }
+        prop_check.unput("BREAKER::cooldown");
+    }
+
+    //Parser of parameter TIMEOUTS::connect
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("connect"))
+        {
+            m_TIMEOUTS_connect = sectionp.find("connect").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::connect' using value:" << m_TIMEOUTS_connect;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::connect' using DEFAULT value:" << m_TIMEOUTS_connect;
+        }
+        prop_check.unput("TIMEOUTS::connect");
+    }
+
+    //Parser of parameter TIMEOUTS::first_byte
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("first_byte"))
+        {
+            m_TIMEOUTS_first_byte = sectionp.find("first_byte").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::first_byte' using value:" << m_TIMEOUTS_first_byte;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::first_byte' using DEFAULT value:" << m_TIMEOUTS_first_byte;
+        }
+        prop_check.unput("TIMEOUTS::first_byte");
+    }
+
+    //Parser of parameter TIMEOUTS::low_speed_limit
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("low_speed_limit"))
+        {
+            m_TIMEOUTS_low_speed_limit = sectionp.find("low_speed_limit").asInt64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::low_speed_limit' using value:" << m_TIMEOUTS_low_speed_limit;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::low_speed_limit' using DEFAULT value:" << m_TIMEOUTS_low_speed_limit;
+        }
+        prop_check.unput("TIMEOUTS::low_speed_limit");
+    }
+
+    //Parser of parameter TIMEOUTS::low_speed_time
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("low_speed_time"))
+        {
+            m_TIMEOUTS_low_speed_time = sectionp.find("low_speed_time").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::low_speed_time' using value:" << m_TIMEOUTS_low_speed_time;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::low_speed_time' using DEFAULT value:" << m_TIMEOUTS_low_speed_time;
+        }
+        prop_check.unput("TIMEOUTS::low_speed_time");
+    }
+
+    //Parser of parameter TIMEOUTS::total
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("total"))
+        {
+            m_TIMEOUTS_total = sectionp.find("total").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::total' using value:" << m_TIMEOUTS_total;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::total' using DEFAULT value:" << m_TIMEOUTS_total;
+        }
+        prop_check.unput("TIMEOUTS::total");
+    }
+
+    //Parser of parameter TIMEOUTS::deadline
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("TIMEOUTS");
+        if (sectionp.check("deadline"))
+        {
+            m_TIMEOUTS_deadline = sectionp.find("deadline").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::deadline' using value:" << m_TIMEOUTS_deadline;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'TIMEOUTS::deadline' using DEFAULT value:" << m_TIMEOUTS_deadline;
+        }
+        prop_check.unput("TIMEOUTS::deadline");
+    }
+
+    //Parser of parameter BARGEIN::cancel_previous
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BARGEIN");
+        if (sectionp.check("cancel_previous"))
+        {
+            m_BARGEIN_cancel_previous = sectionp.find("cancel_previous").asBool();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BARGEIN::cancel_previous' using value:" << m_BARGEIN_cancel_previous;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BARGEIN::cancel_previous' using DEFAULT value:" << m_BARGEIN_cancel_previous;
+        }
+        prop_check.unput("BARGEIN::cancel_previous");
+    }
+
+    //Parser of parameter BARGEIN::rpc_port_name
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("BARGEIN");
+        if (sectionp.check("rpc_port_name"))
+        {
+            m_BARGEIN_rpc_port_name = sectionp.find("rpc_port_name").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BARGEIN::rpc_port_name' using value:" << m_BARGEIN_rpc_port_name;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'BARGEIN::rpc_port_name' using DEFAULT value:" << m_BARGEIN_rpc_port_name;
+        }
+        prop_check.unput("BARGEIN::rpc_port_name");
+    }
+
+    //Parser of parameter FAKE::latency
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("FAKE");
+        if (sectionp.check("latency"))
+        {
+            m_FAKE_latency = sectionp.find("latency").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::latency' using value:" << m_FAKE_latency;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::latency' using DEFAULT value:" << m_FAKE_latency;
+        }
+        prop_check.unput("FAKE::latency");
+    }
+
+    //Parser of parameter FAKE::bandwidth
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("FAKE");
+        if (sectionp.check("bandwidth"))
+        {
+            m_FAKE_bandwidth = sectionp.find("bandwidth").asFloat64();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::bandwidth' using value:" << m_FAKE_bandwidth;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::bandwidth' using DEFAULT value:" << m_FAKE_bandwidth;
+        }
+        prop_check.unput("FAKE::bandwidth");
+    }
+
+    //Parser of parameter FAKE::response_file
+    {
+        yarp::os::Bottle sectionp;
+        sectionp = config.findGroup("FAKE");
+        if (sectionp.check("response_file"))
+        {
+            m_FAKE_response_file = sectionp.find("response_file").asString();
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::response_file' using value:" << m_FAKE_response_file;
+        }
+        else
+        {
+            yCInfo(TtsDeviceParamsCOMPONENT) << "Parameter 'FAKE::response_file' using DEFAULT value:" << m_FAKE_response_file;
+        }
+        prop_check.unput("FAKE::response_file");
+    }
+
     /*
     //This code check if the user set some parameter which are not check by the parser
     //If the parser is set in strict mode, this will generate an error
@@ -185,13 +1039,51 @@ std::string      TtsDevice_ParamsParser::getDocumentationOfDeviceParams() const
     doc = doc + std::string("This is the help for device: TtsDevice\n");
     doc = doc + std::string("\n");
     doc = doc + std::string("This is the list of the parameters accepted by the device:\n");
+    doc = doc + std::string("'AUDIO::response_format': Format of the audio requested to the service: mp3, pcm, wav or opus\n");
     doc = doc + std::string("'ENVS::end_point_name': The name of the environmental variable that stores the APIs endpoint\n");
     doc = doc + std::string("'ENVS::deployment_id_name': The name of the environmental variable that stores the deployment ID\n");
     doc = doc + std::string("'ENVS::api_key_name': The name of the environmental variable that stores the APIs access key\n");
     doc = doc + std::string("'ENVS::api_version_name': The name of the environmental variable that stores the APIs version used\n");
+    doc = doc + std::string("'HTTP::prewarm': If true, the connection to the endpoint is established and verified during open()\n");
+    doc = doc + std::string("'HTTP::keepalive_period': Idle time after which a keep-alive request is sent to the endpoint\n");
+    doc = doc + std::string("'HTTP::http_version': The HTTP version used for the requests: 1.1, 2 or 3\n");
+    doc = doc + std::string("'HTTP::transport': The HTTP transport: curl, or fake to serve canned responses without network\n");
+    doc = doc + std::string("'HTTP::gateway_socket': Unix domain socket of an azureOpenAIGateway the requests are forwarded to\n");
+    doc = doc + std::string("'HTTP::cache_file': File storing the TLS sessions and the addresses of the endpoints across restarts\n");
+    doc = doc + std::string("'HEDGING::enabled': If true, a duplicate request is sent when the first one is late to answer\n");
+    doc = doc + std::string("'HEDGING::percentile': Percentile of the observed time-to-first-byte after which the duplicate is sent\n");
+    doc = doc + std::string("'HEDGING::min_delay': Minimum delay before sending the duplicate request\n");
+    doc = doc + std::string("'HEDGING::default_delay': Delay used until enough latency samples are collected\n");
+    doc = doc + std::string("'HEDGING::deployment_id_name': The name of the environmental variable that stores the deployment ID used for the duplicate requests\n");
+    doc = doc + std::string("'BALANCER::env_suffixes': Suffixes of the environmental variables that describe additional deployments\n");
+    doc = doc + std::string("'BALANCER::ewma_alpha': Weight of the last sample in the moving average of the latency of each deployment\n");
+    doc = doc + std::string("'BALANCER::exploration': Fraction of the requests sent to a random deployment to refresh its latency\n");
+    doc = doc + std::string("'RETRY::max_retries': Maximum number of retries of a request failed with a transient error (transport errors, 408, 429, 5xx)\n");
+    doc = doc + std::string("'RETRY::initial_backoff': Maximum wait before the first retry, doubled at each retry\n");
+    doc = doc + std::string("'RETRY::max_backoff': Maximum wait before a retry\n");
+    doc = doc + std::string("'RETRY::budget': Maximum total wait before the retries of a single request\n");
+    doc = doc + std::string("'LIMITS::requests_per_minute': Maximum number of requests sent per minute, retries included\n");
+    doc = doc + std::string("'LIMITS::characters_per_minute': Maximum number of characters of text synthesized per minute\n");
+    doc = doc + std::string("'LIMITS::burst': Seconds of budget that can be spent at once after an idle period\n");
+    doc = doc + std::string("'LIMITS::adaptive_concurrency': If true, the number of requests in flight adapts to the latency of the deployment\n");
+    doc = doc + std::string("'LIMITS::max_concurrency': Maximum number of requests in flight with LIMITS::adaptive_concurrency\n");
+    doc = doc + std::string("'LIMITS::latency_tolerance': Ratio between the recent and the baseline latency beyond which the number of requests in flight is reduced\n");
+    doc = doc + std::string("'BREAKER::failure_threshold': Consecutive failures of a deployment after which its circuit breaker opens\n");
+    doc = doc + std::string("'BREAKER::cooldown': Time after which a single request is sent to probe a deployment whose circuit is open\n");
+    doc = doc + std::string("'TIMEOUTS::connect': Time allowed to establish the connection to the endpoint, TLS handshake included\n");
+    doc = doc + std::string("'TIMEOUTS::first_byte': Time allowed between sending a request and receiving the first byte of the answer\n");
+    doc = doc + std::string("'TIMEOUTS::low_speed_limit': A transfer slower than this for TIMEOUTS::low_speed_time seconds is aborted\n");
+    doc = doc + std::string("'TIMEOUTS::low_speed_time': See TIMEOUTS::low_speed_limit\n");
+    doc = doc + std::string("'TIMEOUTS::total': Time allowed for a whole request\n");
+    doc = doc + std::string("'TIMEOUTS::deadline': Default time allowed for a call, including the queueing, the retries and the hedged requests\n");
+    doc = doc + std::string("'BARGEIN::cancel_previous': If true, a new synthesize() call cancels the ones still in progress\n");
+    doc = doc + std::string("'BARGEIN::rpc_port_name': Name of an RPC port accepting the cancel command, which aborts the synthesize() calls in progress\n");
+    doc = doc + std::string("'FAKE::latency': Time to the first byte of the responses of the fake transport\n");
+    doc = doc + std::string("'FAKE::bandwidth': Download speed of the responses of the fake transport\n");
+    doc = doc + std::string("'FAKE::response_file': File served as the body of every response of the fake transport\n");
     doc = doc + std::string("\n");
     doc = doc + std::string("Here are some examples of invocation command with yarpdev, with all params:\n");
-    doc = doc + " yarpdev --device ttsDevice --ENVS::end_point_name AZURE_ENDPOINT --ENVS::deployment_id_name DEPLOYMENT_TTS_ID --ENVS::api_key_name AZURE_API_KEY --ENVS::api_version_name AZURE_API_VERSION_TTS\n";
+    doc = doc + " yarpdev --device ttsDevice --AUDIO::response_format mp3 --ENVS::end_point_name AZURE_ENDPOINT --ENVS::deployment_id_name DEPLOYMENT_TTS_ID --ENVS::api_key_name AZURE_API_KEY --ENVS::api_version_name AZURE_API_VERSION_TTS --HTTP::prewarm false --HTTP::keepalive_period 0.0 --HTTP::http_version 2 --HTTP::transport curl --HEDGING::enabled false --HEDGING::percentile 0.95 --HEDGING::min_delay 0.2 --HEDGING::default_delay 1.0 --HEDGING::deployment_id_name DEPLOYMENT_TTS_HEDGE_ID --BALANCER::ewma_alpha 0.2 --BALANCER::exploration 0.05 --RETRY::max_retries 3 --RETRY::initial_backoff 0.5 --RETRY::max_backoff 8.0 --RETRY::budget 10.0 --LIMITS::requests_per_minute 0.0 --LIMITS::characters_per_minute 0.0 --LIMITS::burst 10.0 --LIMITS::adaptive_concurrency false --LIMITS::max_concurrency 64 --LIMITS::latency_tolerance 2.0 --BREAKER::failure_threshold 5 --BREAKER::cooldown 10.0 --TIMEOUTS::connect 5.0 --TIMEOUTS::first_byte 20.0 --TIMEOUTS::low_speed_limit 1000 --TIMEOUTS::low_speed_time 10.0 --TIMEOUTS::total 60.0 --TIMEOUTS::deadline 0.0 --BARGEIN::cancel_previous false --FAKE::latency 0.3 --FAKE::bandwidth 0.0\n";
     doc = doc + std::string("Using only mandatory params:\n");
     doc = doc + " yarpdev --device ttsDevice\n";
     doc = doc + std::string("=============================================\n\n");    return doc;
@@ -8,7 +8,7 @@
 // This is an automatically generated file. Please do not edit it.
 // It will be re-generated if the cmake flag ALLOW_DEVICE_PARAM_PARSER_GERNERATION is ON.
 
-// Generated on: Wed Aug 27 17:37:40 2025
+// Generated on: Sat Oct 17 19:20:00 2026
 
 
 #ifndef TTSDEVICE_PARAMSPARSER_H
@@ -23,16 +23,54 @@
 * This class is the parameters parser for class TtsDevice.
 *
 * These are the used parameters:
-* | Group name | Parameter name     | Type   | Units | Default Value         | Required | Description                                                              | Notes                                     |
-* |:----------:|:------------------:|:------:|:-----:|:---------------------:|:--------:|:------------------------------------------------------------------------:|:-----------------------------------------:|
-* | ENVS       | end_point_name     | string | -     | AZURE_ENDPOINT        | 0        | The name of the environmental variable that stores the APIs endpoint     | Here are additional notes                 |
-* | ENVS       | deployment_id_name | string | -     | DEPLOYMENT_TTS_ID     | 0        | The name of the environmental variable that stores the deployment ID     | Here are additional notes                 |
-* | ENVS       | api_key_name       | string | -     | AZURE_API_KEY         | 0        | The name of the environmental variable that stores the APIs access key   | The default value is the gravity constant |
-* | ENVS       | api_version_name   | string | -     | AZURE_API_VERSION_TTS | 0        | The name of the environmental variable that stores the APIs version used | The default value is the gravity constant |
+* | Group name | Parameter name        | Type           | Units   | Default Value           | Required | Description                                                                                                | Notes                                                                                                                                                                                                                                               |
+* |:----------:|:---------------------:|:--------------:|:-------:|:-----------------------:|:--------:|:----------------------------------------------------------------------------------------------------------:|:---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------:|
+* | AUDIO      | response_format       | string         | -       | mp3                     | 0        | Format of the audio requested to the service: mp3, pcm, wav or opus                                        | pcm and wav (24 kHz, 16 bit, mono) are copied into the Sound without decoding, but are about six times larger than mp3. Useful on fast links with a weak CPU. opus is smaller than mp3, for slow links; it requires a device built with libopusfile |
+* | ENVS       | end_point_name        | string         | -       | AZURE_ENDPOINT          | 0        | The name of the environmental variable that stores the APIs endpoint                                       | Here are additional notes                                                                                                                                                                                                                           |
+* | ENVS       | deployment_id_name    | string         | -       | DEPLOYMENT_TTS_ID       | 0        | The name of the environmental variable that stores the deployment ID                                       | Here are additional notes                                                                                                                                                                                                                           |
+* | ENVS       | api_key_name          | string         | -       | AZURE_API_KEY           | 0        | The name of the environmental variable that stores the APIs access key                                     | The default value is the gravity constant                                                                                                                                                                                                           |
+* | ENVS       | api_version_name      | string         | -       | AZURE_API_VERSION_TTS   | 0        | The name of the environmental variable that stores the APIs version used                                   | The default value is the gravity constant                                                                                                                                                                                                           |
+* | HTTP       | prewarm               | bool           | -       | false                   | 0        | If true, the connection to the endpoint is established and verified during open()                          | open() fails if the endpoint cannot be reached                                                                                                                                                                                                      |
+* | HTTP       | keepalive_period      | double         | s       | 0.0                     | 0        | Idle time after which a keep-alive request is sent to the endpoint                                         | 0 disables the keep-alive requests                                                                                                                                                                                                                  |
+* | HTTP       | http_version          | string         | -       | 2                       | 0        | The HTTP version used for the requests: 1.1, 2 or 3                                                        | With HTTP/2 and HTTP/3 concurrent requests share a single connection. HTTP/3 (QUIC) avoids the head-of-line blocking of TCP on lossy links; it falls back to HTTP/2 if the endpoint or libcurl do not support it                                    |
+* | HTTP       | transport             | string         | -       | curl                    | 0        | The HTTP transport: curl, or fake to serve canned responses without network                                | The fake transport is meant for offline benchmarks, see the FAKE group                                                                                                                                                                              |
+* | HTTP       | gateway_socket        | string         | -       | -                       | 0        | Unix domain socket of an azureOpenAIGateway the requests are forwarded to                                  | If empty, the device connects to Azure directly. The gateway shares its connections and rate limit among all the processes of the machine                                                                                                           |
+* | HTTP       | cache_file            | string         | -       | -                       | 0        | File storing the TLS sessions and the addresses of the endpoints across restarts                           | If set, the first request after a restart resumes the TLS session instead of performing a full handshake. The TLS sessions require libcurl 8.12 or later                                                                                            |
+* | HEDGING    | enabled               | bool           | -       | false                   | 0        | If true, a duplicate request is sent when the first one is late to answer                                  | The first request to answer is used, the other one is cancelled                                                                                                                                                                                     |
+* | HEDGING    | percentile            | double         | -       | 0.95                    | 0        | Percentile of the observed time-to-first-byte after which the duplicate is sent                            | With 0.95 only the slowest 5% of the requests are duplicated                                                                                                                                                                                        |
+* | HEDGING    | min_delay             | double         | s       | 0.2                     | 0        | Minimum delay before sending the duplicate request                                                         | -                                                                                                                                                                                                                                                   |
+* | HEDGING    | default_delay         | double         | s       | 1.0                     | 0        | Delay used until enough latency samples are collected                                                      | -                                                                                                                                                                                                                                                   |
+* | HEDGING    | deployment_id_name    | string         | -       | DEPLOYMENT_TTS_HEDGE_ID | 0        | The name of the environmental variable that stores the deployment ID used for the duplicate requests       | If the variable is not set, the duplicates are sent to the main deployment                                                                                                                                                                          |
+* | BALANCER   | env_suffixes          | vector<string> | -       | -                       | 0        | Suffixes of the environmental variables that describe additional deployments                               | For each suffix S, the variables named as the ENVS ones followed by _S are used                                                                                                                                                                     |
+* | BALANCER   | ewma_alpha            | double         | -       | 0.2                     | 0        | Weight of the last sample in the moving average of the latency of each deployment                          | -                                                                                                                                                                                                                                                   |
+* | BALANCER   | exploration           | double         | -       | 0.05                    | 0        | Fraction of the requests sent to a random deployment to refresh its latency                                | -                                                                                                                                                                                                                                                   |
+* | RETRY      | max_retries           | int            | -       | 3                       | 0        | Maximum number of retries of a request failed with a transient error (transport errors, 408, 429, 5xx)     | 0 disables the retries                                                                                                                                                                                                                              |
+* | RETRY      | initial_backoff       | double         | s       | 0.5                     | 0        | Maximum wait before the first retry, doubled at each retry                                                 | The actual wait is random, the Retry-After headers sent by the server take precedence                                                                                                                                                               |
+* | RETRY      | max_backoff           | double         | s       | 8.0                     | 0        | Maximum wait before a retry                                                                                | -                                                                                                                                                                                                                                                   |
+* | RETRY      | budget                | double         | s       | 10.0                    | 0        | Maximum total wait before the retries of a single request                                                  | -                                                                                                                                                                                                                                                   |
+* | LIMITS     | requests_per_minute   | double         | -       | 0.0                     | 0        | Maximum number of requests sent per minute, retries included                                               | 0 disables the limit. Calls exceeding the limit wait for the available budget. The devices of a process calling the same deployments share the limits of the first one opened                                                                       |
+* | LIMITS     | characters_per_minute | double         | -       | 0.0                     | 0        | Maximum number of characters of text synthesized per minute                                                | 0 disables the limit. Azure counts the characters of the input text                                                                                                                                                                                 |
+* | LIMITS     | burst                 | double         | s       | 10.0                    | 0        | Seconds of budget that can be spent at once after an idle period                                           | -                                                                                                                                                                                                                                                   |
+* | LIMITS     | adaptive_concurrency  | bool           | -       | false                   | 0        | If true, the number of requests in flight adapts to the latency of the deployment                          | The limit grows while the latency stays flat and shrinks when it climbs or the deployment throttles. Useful for batch jobs                                                                                                                          |
+* | LIMITS     | max_concurrency       | int            | -       | 64                      | 0        | Maximum number of requests in flight with LIMITS::adaptive_concurrency                                     | -                                                                                                                                                                                                                                                   |
+* | LIMITS     | latency_tolerance     | double         | -       | 2.0                     | 0        | Ratio between the recent and the baseline latency beyond which the number of requests in flight is reduced | -                                                                                                                                                                                                                                                   |
+* | BREAKER    | failure_threshold     | int            | -       | 5                       | 0        | Consecutive failures of a deployment after which its circuit breaker opens                                 | 0 disables the circuit breaker. While open, the requests are sent to the other deployments or fail immediately                                                                                                                                      |
+* | BREAKER    | cooldown              | double         | s       | 10.0                    | 0        | Time after which a single request is sent to probe a deployment whose circuit is open                      | If the probe succeeds the circuit closes, otherwise it stays open for another cooldown                                                                                                                                                              |
+* | TIMEOUTS   | connect               | double         | s       | 5.0                     | 0        | Time allowed to establish the connection to the endpoint, TLS handshake included                           | 0 disables the timeout                                                                                                                                                                                                                              |
+* | TIMEOUTS   | first_byte            | double         | s       | 20.0                    | 0        | Time allowed between sending a request and receiving the first byte of the answer                          | 0 disables the timeout. It includes the upload of the request                                                                                                                                                                                       |
+* | TIMEOUTS   | low_speed_limit       | int            | bytes/s | 1000                    | 0        | A transfer slower than this for TIMEOUTS::low_speed_time seconds is aborted                                | 0 disables the check                                                                                                                                                                                                                                |
+* | TIMEOUTS   | low_speed_time        | double         | s       | 10.0                    | 0        | See TIMEOUTS::low_speed_limit                                                                              | -                                                                                                                                                                                                                                                   |
+* | TIMEOUTS   | total                 | double         | s       | 60.0                    | 0        | Time allowed for a whole request                                                                           | 0 disables the timeout. Each retry has its own timeouts                                                                                                                                                                                             |
+* | TIMEOUTS   | deadline              | double         | s       | 0.0                     | 0        | Default time allowed for a call, including the queueing, the retries and the hedged requests               | 0 disables the deadline. Used by the callers through the YARP ports; a caller of the same process can shorten it with an azureopenai::DeadlineScope                                                                                                 |
+* | BARGEIN    | cancel_previous       | bool           | -       | false                   | 0        | If true, a new synthesize() call cancels the ones still in progress                                        | Useful when each new sentence interrupts the previous one                                                                                                                                                                                           |
+* | BARGEIN    | rpc_port_name         | string         | -       | -                       | 0        | Name of an RPC port accepting the cancel command, which aborts the synthesize() calls in progress          | If empty, the port is not opened                                                                                                                                                                                                                    |
+* | FAKE       | latency               | double         | s       | 0.3                     | 0        | Time to the first byte of the responses of the fake transport                                              | -                                                                                                                                                                                                                                                   |
+* | FAKE       | bandwidth             | double         | bytes/s | 0.0                     | 0        | Download speed of the responses of the fake transport                                                      | 0 means unlimited                                                                                                                                                                                                                                   |
+* | FAKE       | response_file         | string         | -       | -                       | 0        | File served as the body of every response of the fake transport                                            | If empty, a canned response is served. There is none in the opus format                                                                                                                                                                             |
 *
 * The device can be launched by yarpdev using one of the following examples (with and without all optional parameters):
 * \code{.unparsed}
-* yarpdev --device ttsDevice --ENVS::end_point_name AZURE_ENDPOINT --ENVS::deployment_id_name DEPLOYMENT_TTS_ID --ENVS::api_key_name AZURE_API_KEY --ENVS::api_version_name AZURE_API_VERSION_TTS
+* yarpdev --device ttsDevice --AUDIO::response_format mp3 --ENVS::end_point_name AZURE_ENDPOINT --ENVS::deployment_id_name DEPLOYMENT_TTS_ID --ENVS::api_key_name AZURE_API_KEY --ENVS::api_version_name AZURE_API_VERSION_TTS --HTTP::prewarm false --HTTP::keepalive_period 0.0 --HTTP::http_version 2 --HTTP::transport curl --HEDGING::enabled false --HEDGING::percentile 0.95 --HEDGING::min_delay 0.2 --HEDGING::default_delay 1.0 --HEDGING::deployment_id_name DEPLOYMENT_TTS_HEDGE_ID --BALANCER::ewma_alpha 0.2 --BALANCER::exploration 0.05 --RETRY::max_retries 3 --RETRY::initial_backoff 0.5 --RETRY::max_backoff 8.0 --RETRY::budget 10.0 --LIMITS::requests_per_minute 0.0 --LIMITS::characters_per_minute 0.0 --LIMITS::burst 10.0 --LIMITS::adaptive_concurrency false --LIMITS::max_concurrency 64 --LIMITS::latency_tolerance 2.0 --BREAKER::failure_threshold 5 --BREAKER::cooldown 10.0 --TIMEOUTS::connect 5.0 --TIMEOUTS::first_byte 20.0 --TIMEOUTS::low_speed_limit 1000 --TIMEOUTS::low_speed_time 10.0 --TIMEOUTS::total 60.0 --TIMEOUTS::deadline 0.0 --BARGEIN::cancel_previous false --FAKE::latency 0.3 --FAKE::bandwidth 0.0
 * \endcode
 *
 * \code{.unparsed}
@@ -60,15 +98,91 @@ public:
 
     std::string m_provided_configuration;
 
+    const std::string m_AUDIO_response_format_defaultValue = {"mp3"};
     const std::string m_ENVS_end_point_name_defaultValue = {"AZURE_ENDPOINT"};
     const std::string m_ENVS_deployment_id_name_defaultValue = {"DEPLOYMENT_TTS_ID"};
     const std::string m_ENVS_api_key_name_defaultValue = {"AZURE_API_KEY"};
     const std::string m_ENVS_api_version_name_defaultValue = {"AZURE_API_VERSION_TTS"};
+    const bool m_HTTP_prewarm_defaultValue = {false};
+    const double m_HTTP_keepalive_period_defaultValue = {0.0};
+    const std::string m_HTTP_http_version_defaultValue = {"2"};
+    const std::string m_HTTP_transport_defaultValue = {"curl"};
+    const std::string m_HTTP_gateway_socket_defaultValue = {""};
+    const std::string m_HTTP_cache_file_defaultValue = {""};
+    const bool m_HEDGING_enabled_defaultValue = {false};
+    const double m_HEDGING_percentile_defaultValue = {0.95};
+    const double m_HEDGING_min_delay_defaultValue = {0.2};
+    const double m_HEDGING_default_delay_defaultValue = {1.0};
+    const std::string m_HEDGING_deployment_id_name_defaultValue = {"DEPLOYMENT_TTS_HEDGE_ID"};
+    const std::string m_BALANCER_env_suffixes_defaultValue = {""};
+    const double m_BALANCER_ewma_alpha_defaultValue = {0.2};
+    const double m_BALANCER_exploration_defaultValue = {0.05};
+    const int m_RETRY_max_retries_defaultValue = {3};
+    const double m_RETRY_initial_backoff_defaultValue = {0.5};
+    const double m_RETRY_max_backoff_defaultValue = {8.0};
+    const double m_RETRY_budget_defaultValue = {10.0};
+    const double m_LIMITS_requests_per_minute_defaultValue = {0.0};
+    const double m_LIMITS_characters_per_minute_defaultValue = {0.0};
+    const double m_LIMITS_burst_defaultValue = {10.0};
+    const bool m_LIMITS_adaptive_concurrency_defaultValue = {false};
+    const int m_LIMITS_max_concurrency_defaultValue = {64};
+    const double m_LIMITS_latency_tolerance_defaultValue = {2.0};
+    const int m_BREAKER_failure_threshold_defaultValue = {5};
+    const double m_BREAKER_cooldown_defaultValue = {10.0};
+    const double m_TIMEOUTS_connect_defaultValue = {5.0};
+    const double m_TIMEOUTS_first_byte_defaultValue = {20.0};
+    const int m_TIMEOUTS_low_speed_limit_defaultValue = {1000};
+    const double m_TIMEOUTS_low_speed_time_defaultValue = {10.0};
+    const double m_TIMEOUTS_total_defaultValue = {60.0};
+    const double m_TIMEOUTS_deadline_defaultValue = {0.0};
+    const bool m_BARGEIN_cancel_previous_defaultValue = {false};
+    const std::string m_BARGEIN_rpc_port_name_defaultValue = {""};
+    const double m_FAKE_latency_defaultValue = {0.3};
+    const double m_FAKE_bandwidth_defaultValue = {0.0};
+    const std::string m_FAKE_response_file_defaultValue = {""};
 
+    std::string m_AUDIO_response_format = {"mp3"};
     std::string m_ENVS_end_point_name = {"AZURE_ENDPOINT"};
     std::string m_ENVS_deployment_id_name = {"DEPLOYMENT_TTS_ID"};
     std::string m_ENVS_api_key_name = {"AZURE_API_KEY"};
     std::string m_ENVS_api_version_name = {"AZURE_API_VERSION_TTS"};
+    bool m_HTTP_prewarm = {false};
+    double m_HTTP_keepalive_period = {0.0};
+    std::string m_HTTP_http_version = {"2"};
+    std::string m_HTTP_transport = {"curl"};
+    std::string m_HTTP_gateway_socket = {""};
+    std::string m_HTTP_cache_file = {""};
+    bool m_HEDGING_enabled = {false};
+    double m_HEDGING_percentile = {0.95};
+    double m_HEDGING_min_delay = {0.2};
+    double m_HEDGING_default_delay = {1.0};
+    std::string m_HEDGING_deployment_id_name = {"DEPLOYMENT_TTS_HEDGE_ID"};
+    std::vector<std::string> m_BALANCER_env_suffixes = {}; //The default value of this list is an empty list. It is highly recommended to provide a suggested value also for optional string parameters.
+    double m_BALANCER_ewma_alpha = {0.2};
+    double m_BALANCER_exploration = {0.05};
+    int m_RETRY_max_retries = {3};
+    double m_RETRY_initial_backoff = {0.5};
+    double m_RETRY_max_backoff = {8.0};
+    double m_RETRY_budget = {10.0};
+    double m_LIMITS_requests_per_minute = {0.0};
+    double m_LIMITS_characters_per_minute = {0.0};
+    double m_LIMITS_burst = {10.0};
+    bool m_LIMITS_adaptive_concurrency = {false};
+    int m_LIMITS_max_concurrency = {64};
+    double m_LIMITS_latency_tolerance = {2.0};
+    int m_BREAKER_failure_threshold = {5};
+    double m_BREAKER_cooldown = {10.0};
+    double m_TIMEOUTS_connect = {5.0};
+    double m_TIMEOUTS_first_byte = {20.0};
+    int m_TIMEOUTS_low_speed_limit = {1000};
+    double m_TIMEOUTS_low_speed_time = {10.0};
+    double m_TIMEOUTS_total = {60.0};
+    double m_TIMEOUTS_deadline = {0.0};
+    bool m_BARGEIN_cancel_previous = {false};
+    std::string m_BARGEIN_rpc_port_name = {""};
+    double m_FAKE_latency = {0.3};
+    double m_FAKE_bandwidth = {0.0};
+    std::string m_FAKE_response_file = {""};
 
     bool          parseParams(const yarp::os::Searchable & config) override;
     std::string   getDeviceClassName() const override { return m_device_classname; }
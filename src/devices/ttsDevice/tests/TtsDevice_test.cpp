@@ -4,12 +4,35 @@
  */
 
 #include <yarp/os/Network.h>
+#include <yarp/dev/ISpeechSynthesizer.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/WrapperSingle.h>
+#include <yarp/sig/Sound.h>
 
 #include <catch2/catch_amalgamated.hpp>
 #include <harness.h>
 
+#if defined(WITH_MOCK_AZURE_OPENAI)
+#include <FakeHttpTransport.h>
+#include <MockAzureOpenAIServer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A private copy of the decoder, for the benchmark
+#define DRMP3_API static
+#define DR_MP3_IMPLEMENTATION
+#include "../dr_mp3.h"
+#endif
+
 using namespace yarp::dev;
 using namespace yarp::os;
 
@@ -19,6 +42,20 @@ TEST_CASE("dev::ttsDevice_test", "[yarp::dev]")
 
     Network::setLocalMode(true);
 
+#if defined(WITH_MOCK_AZURE_OPENAI)
+    azureopenai::MockServerOptions options;
+    options.latency = 0.05;
+    options.speechDuration = 1.0;
+    options.retryAfterMs = 50;
+    options.apiKey = "mock-key";
+    azureopenai::MockAzureOpenAIServer server(options);
+    REQUIRE(server.open());
+    setenv("AZURE_ENDPOINT", server.endpoint().c_str(), 1);
+    setenv("AZURE_API_KEY", "mock-key", 1);
+    setenv("DEPLOYMENT_TTS_ID", "tts", 1);
+    setenv("AZURE_API_VERSION_TTS", "2024-05-01-preview", 1);
+#endif
+
     SECTION("Checking the device")
     {
         PolyDriver dd;
@@ -30,8 +67,28 @@ TEST_CASE("dev::ttsDevice_test", "[yarp::dev]")
             REQUIRE(dd.open(pcfg));
         }
 
-        //Do something
-        //...
+#if defined(WITH_MOCK_AZURE_OPENAI)
+        ISpeechSynthesizer* synthesizer = nullptr;
+        REQUIRE(dd.view(synthesizer));
+
+        //"Synthesizing a sentence"
+        {
+            yarp::sig::Sound sound;
+            CHECK(synthesizer->synthesize("Hello world", sound));
+            CHECK(sound.getFrequency() == 44100);
+            CHECK(sound.getSamples() >= 44100);
+        }
+
+        //"Synthesizing a sentence after being throttled"
+        {
+            server.throttleNext(2);
+            yarp::sig::Sound sound;
+            CHECK(synthesizer->synthesize("Hello again", sound));
+            CHECK(sound.getSamples() >= 44100);
+            CHECK(server.stats().throttled == 2);
+            CHECK(server.stats().speech == 2);
+        }
+#endif
 
         //"Close all polydrivers and check"
         {
@@ -39,5 +96,188 @@ TEST_CASE("dev::ttsDevice_test", "[yarp::dev]")
         }
     }
 
+#if defined(WITH_MOCK_AZURE_OPENAI)
+    SECTION("Checking the uncompressed formats")
+    {
+        for (const char* format : {"pcm", "wav"}) {
+            PolyDriver dd;
+            Property pcfg;
+            pcfg.put("device", "ttsDevice");
+            pcfg.addGroup("AUDIO").put("response_format", format);
+            REQUIRE(dd.open(pcfg));
+
+            ISpeechSynthesizer* synthesizer = nullptr;
+            REQUIRE(dd.view(synthesizer));
+            yarp::sig::Sound sound;
+            CHECK(synthesizer->synthesize("Hello world", sound));
+            CHECK(sound.getFrequency() == 24000);
+            CHECK(sound.getSamples() == 24000);
+            CHECK(sound.getChannels() == 1);
+
+            CHECK(dd.close());
+        }
+    }
+
+    SECTION("Checking the cancellation of a call waiting for the quota")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "ttsDevice");
+        Property& limits = pcfg.addGroup("LIMITS");
+        limits.put("characters_per_minute", 60.0);
+        limits.put("burst", 1.0);
+        REQUIRE(dd.open(pcfg));
+        ISpeechSynthesizer* synthesizer = nullptr;
+        REQUIRE(dd.view(synthesizer));
+
+        // The first call leaves a debt of about 30 s of quota
+        yarp::sig::Sound sound;
+        CHECK(synthesizer->synthesize("A sentence of about thirty chars", sound));
+        auto queued = std::async(std::launch::async, [synthesizer]() {
+            yarp::sig::Sound queuedSound;
+            return synthesizer->synthesize("Hello world", queuedSound);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        // Closing cancels the queued call, instead of waiting for the quota
+        auto start = std::chrono::steady_clock::now();
+        CHECK(dd.close());
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+        CHECK_FALSE(queued.get());
+    }
+
+    SECTION("Checking the fake transport without an Opus response")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "ttsDevice");
+        pcfg.addGroup("HTTP").put("transport", "fake");
+        // The environment is complete, the device opens with a format it has a canned response for
+        REQUIRE(dd.open(pcfg));
+        CHECK(dd.close());
+
+        pcfg.addGroup("AUDIO").put("response_format", "opus");
+        CHECK_FALSE(dd.open(pcfg));
+    }
+#endif
+
+    Network::setLocalMode(false);
+}
+
+#if defined(WITH_MOCK_AZURE_OPENAI)
+// Not run by default: [TTS_BENCHMARK_MP3=speech.mp3] ./harness_dev_TtsDevice "[benchmark]"
+// Without TTS_BENCHMARK_MP3 a long silent MP3 is decoded: the two strategies
+// differ only by a few percent, which is negligible. A recording of real
+// speech gives the figure that matters, with the decoding itself more costly.
+TEST_CASE("dev::ttsDevice_decode_benchmark", "[.][benchmark]")
+{
+    std::string mp3Data;
+    if (const char* file = std::getenv("TTS_BENCHMARK_MP3")) {
+        std::ifstream speech(file, std::ios::binary);
+        REQUIRE(speech.good());
+        mp3Data.assign(std::istreambuf_iterator<char>(speech), std::istreambuf_iterator<char>());
+    } else {
+        // A long utterance
+        mp3Data = azureopenai::FakeHttpTransport::silentMp3(120.0);
+    }
+    constexpr drmp3_uint64 chunkFrames = 4096;
+
+    BENCHMARK("Two passes: count the frames, then decode")
+    {
+        drmp3 mp3;
+        REQUIRE(drmp3_init_memory(&mp3, mp3Data.data(), mp3Data.size(), nullptr));
+        drmp3_uint64 totalFrames = drmp3_get_pcm_frame_count(&mp3);
+        std::vector<int16_t> pcm(totalFrames * mp3.channels);
+        drmp3_uint64 framesRead = 0;
+        while (framesRead < totalFrames) {
+            drmp3_uint64 chunk = std::min(chunkFrames, totalFrames - framesRead);
+            drmp3_uint64 read = drmp3_read_pcm_frames_s16(&mp3, chunk, pcm.data() + framesRead * mp3.channels);
+            framesRead += read;
+            if (read < chunk) {
+                break;
+            }
+        }
+        drmp3_uninit(&mp3);
+        return framesRead;
+    };
+
+    // As the device does, reusing the chunks of the previous calls
+    std::vector<std::vector<int16_t>> pool;
+    BENCHMARK("Single pass into pooled chunks")
+    {
+        drmp3 mp3;
+        REQUIRE(drmp3_init_memory(&mp3, mp3Data.data(), mp3Data.size(), nullptr));
+        std::vector<std::vector<int16_t>> chunks;
+        drmp3_uint64 framesRead = 0;
+        while (true) {
+            std::vector<int16_t> chunk;
+            if (!pool.empty()) {
+                chunk = std::move(pool.back());
+                pool.pop_back();
+            }
+            chunk.resize(chunkFrames * mp3.channels);
+            chunks.push_back(std::move(chunk));
+            drmp3_uint64 read = drmp3_read_pcm_frames_s16(&mp3, chunkFrames, chunks.back().data());
+            framesRead += read;
+            if (read < chunkFrames) {
+                break;
+            }
+        }
+        drmp3_uninit(&mp3);
+        for (auto& chunk : chunks) {
+            pool.push_back(std::move(chunk));
+        }
+        return framesRead;
+    };
+}
+#endif
+
+#if defined(WITH_MOCK_AZURE_OPENAI) && defined(WITH_OPUS)
+// Not run by default: TTS_BENCHMARK_MP3=sentence.mp3 TTS_BENCHMARK_OPUS=sentence.opus \
+//     ./harness_dev_TtsDevice "[benchmark]" --benchmark-samples 10
+// with the same sentence synthesized by the service in both formats
+TEST_CASE("dev::ttsDevice_format_benchmark", "[.][benchmark]")
+{
+    YARP_REQUIRE_PLUGIN("ttsDevice", "device");
+
+    Network::setLocalMode(true);
+    setenv("AZURE_ENDPOINT", "http://fake", 1);
+    setenv("AZURE_API_KEY", "fake-key", 1);
+    setenv("DEPLOYMENT_TTS_ID", "tts", 1);
+    setenv("AZURE_API_VERSION_TTS", "2024-05-01-preview", 1);
+
+    for (const char* format : {"mp3", "opus"}) {
+        const char* file = std::getenv(format == std::string("mp3") ? "TTS_BENCHMARK_MP3" : "TTS_BENCHMARK_OPUS");
+        if (file == nullptr) {
+            WARN("TTS_BENCHMARK_MP3 and TTS_BENCHMARK_OPUS not set, skipping the benchmark");
+            break;
+        }
+        std::ifstream response(file, std::ios::binary | std::ios::ate);
+        REQUIRE(response.good());
+
+        // The responses are served at about 128 kbit/s, like a congested cellular link
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "ttsDevice");
+        pcfg.addGroup("AUDIO").put("response_format", format);
+        pcfg.addGroup("HTTP").put("transport", "fake");
+        Property& fake = pcfg.addGroup("FAKE");
+        fake.put("latency", 0.2);
+        fake.put("bandwidth", 16000.0);
+        fake.put("response_file", file);
+        REQUIRE(dd.open(pcfg));
+        ISpeechSynthesizer* synthesizer = nullptr;
+        REQUIRE(dd.view(synthesizer));
+
+        BENCHMARK(std::string(format) + ", " + std::to_string(response.tellg()) + " bytes")
+        {
+            yarp::sig::Sound sound;
+            return synthesizer->synthesize("Hello world", sound);
+        };
+
+        CHECK(dd.close());
+    }
+
     Network::setLocalMode(false);
 }
+#endif
@@ -13,6 +13,7 @@
 #include <yarp/os/LogStream.h>
 
 
+#include <algorithm>
 #include <cmath>
 
 using namespace yarp::os;
@@ -30,32 +31,56 @@ WhisperDevice::WhisperDevice()
 bool WhisperDevice::open(yarp::os::Searchable &config)
 {
     if (!parseParams(config))  { return false; }
-
-    if(std::getenv(m_ENVS_api_key_name.c_str()) == nullptr)
-    {
-        yCError(WHISPERDEVICE) << "Environment variable" << m_ENVS_api_key_name << "not set";
-        return false;
-    }
-    if(std::getenv(m_ENVS_end_point_name.c_str()) == nullptr)
-    {
-        yCError(WHISPERDEVICE) << "Environment variable" << m_ENVS_end_point_name << "not set";
-        return false;
-    }
-    if(std::getenv(m_ENVS_deployment_id_name.c_str()) == nullptr)
     {
-        yCError(WHISPERDEVICE) << "Environment variable" << m_ENVS_deployment_id_name << "not set";
-        return false;
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_closing = false;
     }
-    if(std::getenv(m_ENVS_api_version_name.c_str()) == nullptr)
-    {
-        yCError(WHISPERDEVICE) << "Environment variable" << m_ENVS_api_version_name << "not set";
+
+    azureopenai::ClientOptions options;
+    options.endPointEnv = m_ENVS_end_point_name;
+    options.deploymentIdEnv = m_ENVS_deployment_id_name;
+    options.apiKeyEnv = m_ENVS_api_key_name;
+    options.apiVersionEnv = m_ENVS_api_version_name;
+    options.envSuffixes = m_BALANCER_env_suffixes;
+    options.hedgeDeploymentIdEnv = m_HEDGING_deployment_id_name;
+    options.operation = "audio/transcriptions";
+    // The multipart Content-Type (with its boundary) is set by cURL
+    options.httpVersion = m_HTTP_http_version;
+    options.transport = m_HTTP_transport;
+    options.fake.latency = m_FAKE_latency;
+    options.fake.bandwidth = m_FAKE_bandwidth;
+    options.fakeResponseFile = m_FAKE_response_file;
+    options.gatewaySocket = m_HTTP_gateway_socket;
+    options.cacheFile = m_HTTP_cache_file;
+    options.prewarm = m_HTTP_prewarm;
+    options.keepAlivePeriod = m_HTTP_keepalive_period;
+    options.timeouts.connect = m_TIMEOUTS_connect;
+    options.timeouts.firstByte = m_TIMEOUTS_first_byte;
+    options.timeouts.lowSpeedLimit = m_TIMEOUTS_low_speed_limit;
+    options.timeouts.lowSpeedTime = m_TIMEOUTS_low_speed_time;
+    options.timeouts.total = m_TIMEOUTS_total;
+    options.deadline = m_TIMEOUTS_deadline;
+    options.ewmaAlpha = m_BALANCER_ewma_alpha;
+    options.exploration = m_BALANCER_exploration;
+    options.breaker.failureThreshold = static_cast<unsigned int>(std::max(m_BREAKER_failure_threshold, 0));
+    options.breaker.cooldown = m_BREAKER_cooldown;
+    options.retry.maxRetries = static_cast<unsigned int>(std::max(m_RETRY_max_retries, 0));
+    options.retry.initialBackoff = m_RETRY_initial_backoff;
+    options.retry.maxBackoff = m_RETRY_max_backoff;
+    options.retry.budget = m_RETRY_budget;
+    options.requestsPerMinute = m_LIMITS_requests_per_minute;
+    options.unitsPerMinute = m_LIMITS_audio_seconds_per_minute;
+    options.burst = m_LIMITS_burst;
+    options.concurrency.enabled = m_LIMITS_adaptive_concurrency;
+    options.concurrency.maxLimit = static_cast<size_t>(std::max(m_LIMITS_max_concurrency, 1));
+    options.concurrency.latencyTolerance = m_LIMITS_latency_tolerance;
+    options.hedging.enabled = m_HEDGING_enabled;
+    options.hedging.quantile = m_HEDGING_percentile;
+    options.hedging.minDelay = m_HEDGING_min_delay;
+    options.hedging.defaultDelay = m_HEDGING_default_delay;
+    if (!m_client.open(options)) {
         return false;
     }
-    m_apiKey = std::getenv(m_ENVS_api_key_name.c_str());
-    std::string endpoint = std::getenv(m_ENVS_end_point_name.c_str());
-    std::string deployment_id = std::getenv(m_ENVS_deployment_id_name.c_str());
-    std::string api_version = std::getenv(m_ENVS_api_version_name.c_str());
-    m_url = endpoint + "/openai/deployments/" + deployment_id + "/audio/transcriptions?api-version=" + api_version;
 
     yCInfo(WHISPERDEVICE) << "Open";
     return true;
@@ -63,6 +88,20 @@ bool WhisperDevice::open(yarp::os::Searchable &config)
 
 bool WhisperDevice::close()
 {
+    std::set<std::shared_ptr<azureopenai::CancellationToken>> inFlight;
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_closing = true;
+        inFlight.swap(m_inFlight);
+    }
+    for (const auto& token : inFlight) {
+        token->cancel();
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_inFlightMutex);
+        m_callsDone.wait(lock, [this] { return m_calls == 0; });
+    }
+    m_client.close();
     yCInfo(WHISPERDEVICE) << "Close";
     return true;
 }
@@ -82,52 +121,78 @@ ReturnValue WhisperDevice::getLanguage(std::string& language)
 ReturnValue WhisperDevice::transcribe(const yarp::sig::Sound& sound, std::string& transcription, double& score)
 {
     score = 0.0;
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        yCError(WHISPERDEVICE) << "Failed to initialize cURL";
-        return yarp::dev::ReturnValue::return_code::return_value_error_generic;
+    auto token = _beginCall();
+    if (!token) {
+        yCError(WHISPERDEVICE) << "The device is closing";
+        return ReturnValue::return_code::return_value_error_generic;
     }
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, ("api-key: " + m_apiKey).c_str());
-    headers = curl_slist_append(headers, "Content-Type: multipart/form-data");
+    ReturnValue ret = _transcribe(sound, transcription, score, token);
+    _endCall(token);
+    return ret;
+}
+
+std::shared_ptr<azureopenai::CancellationToken> WhisperDevice::_beginCall()
+{
+    auto token = std::make_shared<azureopenai::CancellationToken>();
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    if (m_closing) {
+        return nullptr;
+    }
+    m_inFlight.insert(token);
+    ++m_calls;
+    return token;
+}
+
+void WhisperDevice::_endCall(const std::shared_ptr<azureopenai::CancellationToken>& token)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        m_inFlight.erase(token);
+        --m_calls;
+    }
+    m_callsDone.notify_all();
+}
+
+ReturnValue WhisperDevice::_transcribe(const yarp::sig::Sound& sound, std::string& transcription, double& score, const std::shared_ptr<azureopenai::CancellationToken>& token)
+{
 
     int sampleRate = sound.getFrequency();
     std::vector<uint8_t> wavHeader = _createWavHeader(sampleRate, sound.getSamples());
-    std::vector<uint8_t> audioData(wavHeader.begin(), wavHeader.end());
+    std::string audioData(wavHeader.begin(), wavHeader.end());
+    audioData.reserve(wavHeader.size() + sound.getSamples() * 2);
 
     for (size_t i = 0; i < sound.getSamples(); ++i) {
         int16_t sample = static_cast<int16_t>(sound.get(i));
-        audioData.push_back(sample & 0xFF);
-        audioData.push_back((sample >> 8) & 0xFF);
+        audioData.push_back(static_cast<char>(sample & 0xFF));
+        audioData.push_back(static_cast<char>((sample >> 8) & 0xFF));
     }
 
-    struct curl_httppost *post = NULL;
-    struct curl_httppost *last = NULL;
-    curl_formadd(&post, &last,
-                 CURLFORM_COPYNAME, "file",
-                 CURLFORM_BUFFER, "audio.wav",
-                 CURLFORM_BUFFERPTR, audioData.data(),
-                 CURLFORM_BUFFERLENGTH, audioData.size(),
-                 CURLFORM_CONTENTTYPE, "audio/wav",
-                 CURLFORM_END);
-    curl_formadd(&post, &last,
-                 CURLFORM_COPYNAME, "response_format",
-                 CURLFORM_COPYCONTENTS, "verbose_json",
-                 CURLFORM_END);
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, m_url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_HTTPPOST, post);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        yCError(WHISPERDEVICE) << "cURL request failed: " << curl_easy_strerror(res);
-    } else {
-        yCDebug(WHISPERDEVICE) << "Transcription response: " << response;
+    azureopenai::HttpRequest request = m_client.newRequest();
+    request.cancellation = token;
+    request.quotaUnits = sampleRate > 0 ? static_cast<double>(sound.getSamples()) / sampleRate : 0.0;
+    request.parts.push_back({"file", std::move(audioData), "audio.wav", "audio/wav"});
+    request.parts.push_back({"response_format", "verbose_json", "", ""});
+
+    azureopenai::HttpResponse httpResponse = m_client.perform(std::move(request));
+    const std::string& response = httpResponse.body;
+
+    if (token->isCancelled()) {
+        yCInfo(WHISPERDEVICE) << "Transcription cancelled";
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    if (httpResponse.deadlineExceeded) {
+        yCError(WHISPERDEVICE) << "Transcription abandoned, its deadline expired";
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    if (httpResponse.result != CURLE_OK) {
+        yCError(WHISPERDEVICE) << "cURL request failed: " << curl_easy_strerror(httpResponse.result);
+        return ReturnValue::return_code::return_value_error_generic;
     }
+    if (!httpResponse.ok()) {
+        yCError(WHISPERDEVICE) << "Transcription request failed with HTTP status" << httpResponse.status << ":" << response;
+        return ReturnValue::return_code::return_value_error_generic;
+    }
+    yCDebug(WHISPERDEVICE) << "Transcription response: " << response;
 
     // Parse the JSON response
     try {
@@ -157,10 +222,6 @@ ReturnValue WhisperDevice::transcribe(const yarp::sig::Sound& sound, std::string
         return ReturnValue::return_code::return_value_error_generic;
     }
 
-    curl_easy_cleanup(curl);
-    curl_formfree(post);
-    curl_slist_free_all(headers);
-
     return ReturnValue::return_code::return_value_ok;
 }
 
@@ -192,9 +253,3 @@ std::vector<uint8_t> WhisperDevice::_createWavHeader(int sampleRate, int numSamp
 
     return header;
 }
-
-size_t WhisperDevice::_writeCallback(void *contents, size_t size, size_t nmemb, std::string *output) {
-    size_t totalSize = size * nmemb;
-    output->append((char*)contents, totalSize);
-    return totalSize;
-}
\ No newline at end of file
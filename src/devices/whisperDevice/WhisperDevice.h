@@ -14,6 +14,10 @@
 #include <sstream>
 #include <iterator>
 #include <cstring>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
 
 #include <nlohmann/json.hpp>
 
@@ -23,6 +27,8 @@
 #include <yarp/sig/Sound.h>
 
 #include "WhisperDevice_ParamsParser.h"
+#include "AzureOpenAIClient.h"
+#include "CancellationToken.h"
 
 /**
  *  @ingroup dev_impl_other
@@ -58,12 +64,19 @@ public:
     yarp::dev::ReturnValue transcribe(const yarp::sig::Sound& sound, std::string& transcription, double& score) override;
 
 private:
-    std::string m_url;
-    std::string m_apiKey;
-    struct curl_slist *headers{nullptr};
+    azureopenai::AzureOpenAIClient m_client;
+    // transcribe() calls in progress, cancelled and waited for by close()
+    std::mutex m_inFlightMutex;
+    std::set<std::shared_ptr<azureopenai::CancellationToken>> m_inFlight;
+    std::condition_variable m_callsDone;
+    size_t m_calls{0};
+    bool m_closing{false};
+
+    std::shared_ptr<azureopenai::CancellationToken> _beginCall();
+    void _endCall(const std::shared_ptr<azureopenai::CancellationToken>& token);
+    yarp::dev::ReturnValue _transcribe(const yarp::sig::Sound& sound, std::string& transcription, double& score, const std::shared_ptr<azureopenai::CancellationToken>& token);
 
     std::vector<uint8_t> _createWavHeader(int sampleRate, int numSamples);
-    static size_t _writeCallback(void *contents, size_t size, size_t nmemb, std::string *output);
 };
 
 #endif // YARP_WHISPERDEVICE_H
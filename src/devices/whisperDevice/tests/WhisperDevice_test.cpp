@@ -4,12 +4,20 @@
  */
 
 #include <yarp/os/Network.h>
+#include <yarp/dev/ISpeechTranscription.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/WrapperSingle.h>
+#include <yarp/sig/Sound.h>
 
 #include <catch2/catch_amalgamated.hpp>
 #include <harness.h>
 
+#if defined(WITH_MOCK_AZURE_OPENAI)
+#include <MockAzureOpenAIServer.h>
+
+#include <cstdlib>
+#endif
+
 using namespace yarp::dev;
 using namespace yarp::os;
 
@@ -19,6 +27,20 @@ TEST_CASE("dev::whisperDevice_test", "[yarp::dev]")
 
     Network::setLocalMode(true);
 
+#if defined(WITH_MOCK_AZURE_OPENAI)
+    azureopenai::MockServerOptions options;
+    options.latency = 0.05;
+    options.transcription = "Hello world";
+    options.retryAfterMs = 50;
+    options.apiKey = "mock-key";
+    azureopenai::MockAzureOpenAIServer server(options);
+    REQUIRE(server.open());
+    setenv("AZURE_ENDPOINT", server.endpoint().c_str(), 1);
+    setenv("AZURE_API_KEY", "mock-key", 1);
+    setenv("DEPLOYMENT_WHISPER_ID", "whisper", 1);
+    setenv("AZURE_API_VERSION_TTS", "2024-06-01", 1);
+#endif
+
     SECTION("Checking the device")
     {
         PolyDriver dd;
@@ -30,8 +52,34 @@ TEST_CASE("dev::whisperDevice_test", "[yarp::dev]")
             REQUIRE(dd.open(pcfg));
         }
 
-        //Do something
-        //...
+#if defined(WITH_MOCK_AZURE_OPENAI)
+        ISpeechTranscription* transcriber = nullptr;
+        REQUIRE(dd.view(transcriber));
+
+        yarp::sig::Sound sound;
+        sound.setFrequency(16000);
+        sound.resize(16000, 1);
+
+        //"Transcribing one second of audio"
+        {
+            std::string transcription;
+            double score = 0.0;
+            CHECK(transcriber->transcribe(sound, transcription, score));
+            CHECK(transcription == "Hello world");
+            CHECK(score > 0.0);
+        }
+
+        //"Transcribing after being throttled"
+        {
+            server.throttleNext(2);
+            std::string transcription;
+            double score = 0.0;
+            CHECK(transcriber->transcribe(sound, transcription, score));
+            CHECK(transcription == "Hello world");
+            CHECK(server.stats().throttled == 2);
+            CHECK(server.stats().transcriptions == 2);
+        }
+#endif
 
         //"Close all polydrivers and check"
         {
@@ -0,0 +1,357 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "AzureOpenAIClient.h"
+
+#include "ConcurrencyLimiter.h"
+#include "Deadline.h"
+#include "HttpEngine.h"
+#include "RateLimiter.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(AZUREOPENAICLIENT, "yarp.azureOpenAIClient.AzureOpenAIClient")
+
+const char* getEnv(const std::string& name)
+{
+    const char* value = std::getenv(name.c_str());
+    if (value == nullptr) {
+        yCError(AZUREOPENAICLIENT) << "Environment variable" << name << "not set";
+    }
+    return value;
+}
+
+// Objects shared by the clients of the process that call the same deployments,
+// like SharedHttpState; they are destroyed with the last client using them
+template <typename T>
+class SharedRegistry
+{
+public:
+    template <typename Make>
+    std::shared_ptr<T> acquire(const std::string& key, Make make)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            it = it->second.expired() ? m_entries.erase(it) : std::next(it);
+        }
+        std::shared_ptr<T> shared = m_entries[key].lock();
+        if (!shared) {
+            shared = make();
+            m_entries[key] = shared;
+        } else {
+            yCDebug(AZUREOPENAICLIENT) << "Sharing the state of" << key << "with another client";
+        }
+        return shared;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<std::string, std::weak_ptr<T>> m_entries;
+};
+
+SharedRegistry<EndpointPool> s_endpointPools;
+SharedRegistry<RateLimiter> s_rateLimiters;
+SharedRegistry<ConcurrencyLimiter> s_concurrencyLimiters;
+} // namespace
+
+AzureOpenAIClient::~AzureOpenAIClient()
+{
+    close();
+}
+
+bool AzureOpenAIClient::open(const ClientOptions& options)
+{
+    close();
+    m_options = options;
+
+    if (!HttpEngine::httpVersionFromString(m_options.httpVersion, m_httpVersion)) {
+        yCError(AZUREOPENAICLIENT) << "Invalid HTTP::http_version" << m_options.httpVersion << "(valid values are 1.1, 2 and 3)";
+        return false;
+    }
+    if (m_options.transport != "curl" && m_options.transport != "fake") {
+        yCError(AZUREOPENAICLIENT) << "Invalid HTTP::transport" << m_options.transport << "(valid values are curl and fake)";
+        return false;
+    }
+    if (!m_options.gatewaySocket.empty() && m_options.transport != "curl") {
+        yCWarning(AZUREOPENAICLIENT) << "HTTP::gateway_socket is ignored by the" << m_options.transport << "transport";
+        m_options.gatewaySocket.clear();
+    }
+
+    const char* apiKey = getEnv(m_options.apiKeyEnv);
+    const char* endpoint = getEnv(m_options.endPointEnv);
+    const char* deploymentId = getEnv(m_options.deploymentIdEnv);
+    const char* apiVersion = getEnv(m_options.apiVersionEnv);
+    if (apiKey == nullptr || endpoint == nullptr || deploymentId == nullptr || apiVersion == nullptr) {
+        return false;
+    }
+    m_deployments.push_back(_deployment("main", _url(endpoint, deploymentId, apiVersion), apiKey));
+    m_url = m_deployments.front().url;
+    for (const auto& suffix : m_options.envSuffixes) {
+        if (!_addDeployment(suffix, apiKey, apiVersion)) {
+            close();
+            return false;
+        }
+    }
+    const char* hedgeDeploymentId = m_options.hedgeDeploymentIdEnv.empty() ? nullptr : std::getenv(m_options.hedgeDeploymentIdEnv.c_str());
+    if (hedgeDeploymentId != nullptr) {
+        m_hedgeUrl = _deployment("hedge", _url(endpoint, hedgeDeploymentId, apiVersion), apiKey).url;
+    }
+
+    m_headers = curl_slist_append(m_headers, ("api-key: " + std::string(apiKey)).c_str());
+    for (const auto& header : m_options.headers) {
+        m_headers = curl_slist_append(m_headers, header.c_str());
+    }
+    for (const auto& header : m_deployments.front().headers) {
+        m_headers = curl_slist_append(m_headers, header.c_str());
+    }
+
+    if (!_initTransport() || !_warmUp()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AzureOpenAIClient::close()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_callsMutex);
+        m_closing = true;
+        m_callsDone.wait(lock, [this] { return m_calls == 0; });
+    }
+
+    if (m_client) {
+        ClientMetrics metrics = this->metrics();
+        yCDebug(AZUREOPENAICLIENT) << "Calls to" << m_options.operation << ":" << metrics.calls
+                                   << "failed:" << metrics.failures
+                                   << "deadline exceeded:" << metrics.deadlineExceeded
+                                   << "cancelled:" << metrics.cancelled;
+    }
+    m_warmers.clear();
+    m_client.reset();
+    m_endpoints.reset();
+    m_transport.reset();
+    curl_slist_free_all(m_headers);
+    m_headers = nullptr;
+    m_httpState.reset();
+    m_deployments.clear();
+    m_url.clear();
+    m_hedgeUrl.clear();
+
+    std::lock_guard<std::mutex> lock(m_callsMutex);
+    m_closing = false;
+}
+
+HttpRequest AzureOpenAIClient::newRequest() const
+{
+    HttpRequest request;
+    request.url = m_url;
+    request.headers = m_headers;
+    request.httpVersion = m_httpVersion;
+    request.timeouts = m_options.timeouts;
+    request.unixSocket = m_options.gatewaySocket;
+    // A DeadlineScope of the caller can only shorten the default deadline
+    request.deadline = std::min(DeadlineScope::current(), DeadlineScope::fromNow(m_options.deadline));
+    return request;
+}
+
+HttpResponse AzureOpenAIClient::perform(HttpRequest request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callsMutex);
+        if (!m_client || m_closing) {
+            HttpResponse response;
+            response.result = CURLE_FAILED_INIT;
+            return response;
+        }
+        ++m_calls;
+    }
+    HttpResponse response = _perform(std::move(request));
+    {
+        std::lock_guard<std::mutex> lock(m_callsMutex);
+        --m_calls;
+    }
+    m_callsDone.notify_all();
+    return response;
+}
+
+HttpResponse AzureOpenAIClient::_perform(HttpRequest request)
+{
+    auto cancellation = request.cancellation;
+    auto start = std::chrono::steady_clock::now();
+
+    // Several callers can wait here concurrently, the transfers run on the engine thread
+    HttpResponse response = m_client->perform(std::move(request));
+    // Only the connection of the deployment that answered was used, the others may need their keep-alive
+    if (response.endpoint < m_warmers.size()) {
+        m_warmers[response.endpoint]->notifyActivity();
+    }
+
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    ++m_metrics.calls;
+    if (response.deadlineExceeded) {
+        ++m_metrics.deadlineExceeded;
+    } else if (cancellation && cancellation->isCancelled()) {
+        ++m_metrics.cancelled;
+    } else if (!response.ok()) {
+        ++m_metrics.failures;
+    } else {
+        m_metrics.totalTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return response;
+}
+
+ClientMetrics AzureOpenAIClient::metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    return m_metrics;
+}
+
+bool AzureOpenAIClient::_addDeployment(const std::string& suffix, const std::string& apiKey, const std::string& apiVersion)
+{
+    // Additional deployments are described by the same environment variables of the
+    // main one, followed by "_<suffix>". The api key and version default to the main ones.
+    const char* endpoint = getEnv(m_options.endPointEnv + "_" + suffix);
+    const char* deploymentId = getEnv(m_options.deploymentIdEnv + "_" + suffix);
+    if (endpoint == nullptr || deploymentId == nullptr) {
+        return false;
+    }
+    const char* deploymentApiKey = std::getenv((m_options.apiKeyEnv + "_" + suffix).c_str());
+    const char* deploymentApiVersion = std::getenv((m_options.apiVersionEnv + "_" + suffix).c_str());
+    m_deployments.push_back(_deployment(suffix,
+                                        _url(endpoint, deploymentId, deploymentApiVersion ? deploymentApiVersion : apiVersion),
+                                        deploymentApiKey ? deploymentApiKey : apiKey));
+    return true;
+}
+
+AzureOpenAIClient::Deployment AzureOpenAIClient::_deployment(const std::string& name, const std::string& url, const std::string& apiKey) const
+{
+    Deployment deployment{name, url, apiKey, {}};
+    if (!m_options.gatewaySocket.empty()) {
+        // The gateway terminates the TLS connections to Azure: the devices speak plain
+        // HTTP on the local socket, and tell the gateway which scheme to use upstream
+        size_t schemeEnd = url.find("://");
+        if (schemeEnd != std::string::npos) {
+            deployment.url = "http" + url.substr(schemeEnd);
+            deployment.headers.push_back("X-Forwarded-Proto: " + url.substr(0, schemeEnd));
+        }
+    }
+    return deployment;
+}
+
+std::string AzureOpenAIClient::_url(const std::string& endpoint, const std::string& deploymentId, const std::string& apiVersion) const
+{
+    return endpoint + "/openai/deployments/" + deploymentId + "/" + m_options.operation + "?api-version=" + apiVersion;
+}
+
+bool AzureOpenAIClient::_initTransport()
+{
+    // Requests are performed by the process-wide engine, whose handles are attached to
+    // the shared caches, so that consecutive requests (also from other devices) reuse
+    // the same DNS entry, TLS session and connection
+    m_httpState = SharedHttpState::acquire();
+    if (m_options.transport == "fake") {
+        yCWarning(AZUREOPENAICLIENT) << "Using the fake HTTP transport, requests are not sent to Azure";
+        FakeHttpOptions fake = m_options.fake;
+        if (!m_options.fakeResponseFile.empty()) {
+            std::ifstream file(m_options.fakeResponseFile, std::ios::binary);
+            if (!file) {
+                yCError(AZUREOPENAICLIENT) << "Unable to read" << m_options.fakeResponseFile;
+                return false;
+            }
+            fake.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        m_transport = std::make_shared<FakeHttpTransport>(fake);
+    } else {
+        if (!m_options.cacheFile.empty()) {
+            m_httpState->useCacheFile(m_options.cacheFile);
+        }
+        m_transport = HttpEngine::acquire();
+    }
+    m_client = std::make_unique<HttpClient>(m_transport);
+
+    // The quotas and the health of the deployments are the same for all the
+    // clients of the process calling them
+    std::string key = m_options.transport + " " + m_options.gatewaySocket;
+    for (const auto& deployment : m_deployments) {
+        key += " " + deployment.url;
+    }
+    m_endpoints = s_endpointPools.acquire(key, [this]() {
+        auto endpoints = std::make_shared<EndpointPool>(m_options.ewmaAlpha, m_options.exploration);
+        endpoints->setCircuitBreaker(m_options.breaker);
+        for (const auto& deployment : m_deployments) {
+            std::vector<std::string> headers{"api-key: " + deployment.apiKey};
+            headers.insert(headers.end(), m_options.headers.begin(), m_options.headers.end());
+            headers.insert(headers.end(), deployment.headers.begin(), deployment.headers.end());
+            endpoints->add(deployment.name, deployment.url, headers);
+        }
+        return endpoints;
+    });
+    m_client->setEndpoints(m_endpoints);
+
+    m_client->setRetry(m_options.retry);
+    m_client->setRateLimiter(s_rateLimiters.acquire(key, [this]() {
+        return std::make_shared<RateLimiter>(m_options.requestsPerMinute, m_options.unitsPerMinute, m_options.burst);
+    }));
+    if (m_options.concurrency.enabled) {
+        m_client->setConcurrencyLimiter(s_concurrencyLimiters.acquire(key, [this]() {
+            return std::make_shared<ConcurrencyLimiter>(m_options.concurrency);
+        }));
+    }
+
+    if (m_options.hedging.enabled) {
+        HttpTarget hedgeTarget;
+        if (!m_hedgeUrl.empty()) {
+            hedgeTarget = {m_hedgeUrl, m_headers};
+        }
+        m_client->setHedging(m_options.hedging, hedgeTarget);
+    }
+    return true;
+}
+
+bool AzureOpenAIClient::_warmUp()
+{
+    // The fake transport does not need any connection
+    if (m_options.transport != "curl") {
+        return true;
+    }
+
+    // An unreachable deployment is only penalized, as long as another one answers
+    size_t reachable = 0;
+    for (size_t i = 0; i < m_deployments.size(); ++i) {
+        auto warmer = std::make_unique<ConnectionWarmer>(m_transport, m_deployments[i].url, m_deployments[i].apiKey,
+                                                         m_options.gatewaySocket, m_deployments[i].headers, m_httpVersion);
+        if (m_options.prewarm) {
+            if (warmer->warmUp()) {
+                ++reachable;
+            } else {
+                yCWarning(AZUREOPENAICLIENT) << "Unable to establish the connection to deployment" << m_deployments[i].name;
+                m_endpoints->reportFailure(i);
+            }
+        }
+        warmer->startKeepAlive(m_options.keepAlivePeriod);
+        m_warmers.push_back(std::move(warmer));
+    }
+    if (m_options.prewarm && reachable == 0) {
+        yCError(AZUREOPENAICLIENT) << "Unable to establish the connection to" << m_url;
+        return false;
+    }
+    if (reachable > 0) {
+        // Save the fresh sessions now, the process may not exit cleanly
+        m_httpState->saveCache();
+    }
+    return true;
+}
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_AZUREOPENAICLIENT_H
+#define AZUREOPENAI_AZUREOPENAICLIENT_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ConnectionWarmer.h"
+#include "EndpointPool.h"
+#include "FakeHttpTransport.h"
+#include "HttpClient.h"
+#include "HttpRequest.h"
+#include "SharedHttpState.h"
+
+namespace azureopenai {
+
+/**
+ * \brief Configuration of an AzureOpenAIClient, filled from the parameters of a device.
+ */
+struct ClientOptions
+{
+    // Names of the environment variables describing the main deployment
+    std::string endPointEnv{"AZURE_ENDPOINT"};
+    std::string deploymentIdEnv;
+    std::string apiKeyEnv{"AZURE_API_KEY"};
+    std::string apiVersionEnv;
+    // Suffixes of the environment variables describing the additional deployments
+    std::vector<std::string> envSuffixes;
+    // Name of the environment variable storing the deployment of the hedged requests
+    std::string hedgeDeploymentIdEnv;
+
+    // The API called, e.g. audio/speech
+    std::string operation;
+    // Headers sent with every request, in addition to the api-key
+    std::vector<std::string> headers;
+
+    // "1.1", "2" or "3"
+    std::string httpVersion{"2"};
+    // "curl", or "fake" to serve canned responses
+    std::string transport{"curl"};
+    FakeHttpOptions fake;
+    // If not empty, file served as the body of every response of the fake transport
+    std::string fakeResponseFile;
+    // If not empty, the requests are forwarded to the azureOpenAIGateway listening on this Unix domain socket
+    std::string gatewaySocket;
+    // If not empty, file storing the TLS sessions and the addresses across restarts, see SharedHttpState
+    std::string cacheFile;
+    bool prewarm{false};
+    // Idle time after which a keep-alive request is sent, 0 to disable [s]
+    double keepAlivePeriod{0.0};
+
+    HttpTimeouts timeouts;
+    // Default time allowed for a call, 0 for none [s]
+    double deadline{0.0};
+    double ewmaAlpha{0.2};
+    double exploration{0.05};
+    CircuitBreakerOptions breaker;
+    RetryOptions retry;
+    double requestsPerMinute{0.0};
+    // Quota units (characters, seconds of audio...) per minute, 0 for no limit
+    double unitsPerMinute{0.0};
+    double burst{10.0};
+    ConcurrencyOptions concurrency;
+    HedgingOptions hedging;
+};
+
+/**
+ * \brief Counters of the calls performed by an AzureOpenAIClient.
+ */
+struct ClientMetrics
+{
+    size_t calls{0};
+    size_t failures{0};
+    size_t deadlineExceeded{0};
+    size_t cancelled{0};
+    // Sum of the duration of the successful calls [s]
+    double totalTime{0.0};
+};
+
+/**
+ * \brief Everything a device needs to call an Azure OpenAI deployment.
+ *
+ * It reads the deployments from the environment, builds their urls and
+ * headers, and owns the HttpClient with its policies (balancing, retries,
+ * limits, hedging) and the connection warmers. The transfers run on the
+ * process-wide HttpEngine, so all the devices of a process share one
+ * connection pool. The clients of a process calling the same deployments
+ * also share their rate and concurrency limits and the state of the
+ * deployments (latency, circuit breakers); the options of the first client
+ * opened apply.
+ */
+class AzureOpenAIClient
+{
+public:
+    AzureOpenAIClient() = default;
+    AzureOpenAIClient(const AzureOpenAIClient&) = delete;
+    AzureOpenAIClient(AzureOpenAIClient&&) noexcept = delete;
+    AzureOpenAIClient& operator=(const AzureOpenAIClient&) = delete;
+    AzureOpenAIClient& operator=(AzureOpenAIClient&&) noexcept = delete;
+    ~AzureOpenAIClient();
+
+    /**
+     * Read the deployments and set up the request path.
+     * \return false, after logging the reason, if the configuration is invalid
+     *         or, with prewarm, if no deployment is reachable.
+     */
+    bool open(const ClientOptions& options);
+
+    /**
+     * Wait for the perform() calls in progress to return (cancel them first,
+     * to avoid waiting for their responses), then release everything.
+     */
+    void close();
+
+    /**
+     * A request to the main deployment, with the headers, the HTTP version,
+     * the timeouts and the deadline (the earliest of the current DeadlineScope
+     * and the default one) already set.
+     */
+    HttpRequest newRequest() const;
+
+    /**
+     * Perform a request, see HttpClient::perform(). It can be called
+     * concurrently, it fails once close() has started.
+     */
+    HttpResponse perform(HttpRequest request);
+
+    ClientMetrics metrics() const;
+
+private:
+    struct Deployment
+    {
+        std::string name;
+        std::string url;
+        std::string apiKey;
+        // Headers sent in addition to the api-key and ClientOptions::headers
+        std::vector<std::string> headers;
+    };
+
+    bool _addDeployment(const std::string& suffix, const std::string& apiKey, const std::string& apiVersion);
+    std::string _url(const std::string& endpoint, const std::string& deploymentId, const std::string& apiVersion) const;
+    Deployment _deployment(const std::string& name, const std::string& url, const std::string& apiKey) const;
+    HttpResponse _perform(HttpRequest request);
+    bool _initTransport();
+    bool _warmUp();
+
+    ClientOptions m_options;
+    long m_httpVersion{CURL_HTTP_VERSION_2TLS};
+    std::string m_url;
+    std::string m_hedgeUrl;
+    std::vector<Deployment> m_deployments;
+    std::shared_ptr<SharedHttpState> m_httpState;
+    std::shared_ptr<IHttpTransport> m_transport;
+    std::unique_ptr<HttpClient> m_client;
+    std::shared_ptr<EndpointPool> m_endpoints;
+    std::vector<std::unique_ptr<ConnectionWarmer>> m_warmers;
+    struct curl_slist* m_headers{nullptr};
+
+    // perform() calls in progress, close() waits for them
+    std::mutex m_callsMutex;
+    std::condition_variable m_callsDone;
+    size_t m_calls{0};
+    bool m_closing{false};
+
+    mutable std::mutex m_metricsMutex;
+    ClientMetrics m_metrics;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_AZUREOPENAICLIENT_H
@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "CancellationToken.h"
+
+#include <chrono>
+
+using namespace azureopenai;
+
+void CancellationToken::cancel()
+{
+    std::map<size_t, std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancelled) {
+            return;
+        }
+        m_cancelled = true;
+        callbacks.swap(m_callbacks);
+    }
+    m_cv.notify_all();
+    for (auto& [id, callback] : callbacks) {
+        callback();
+    }
+}
+
+bool CancellationToken::isCancelled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cancelled;
+}
+
+bool CancellationToken::waitFor(double seconds) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_cv.wait_for(lock, std::chrono::duration<double>(seconds), [this] { return m_cancelled; });
+}
+
+size_t CancellationToken::subscribe(std::function<void()> callback)
+{
+    size_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = m_nextId++;
+        if (!m_cancelled) {
+            m_callbacks[id] = std::move(callback);
+            return id;
+        }
+    }
+    callback();
+    return id;
+}
+
+void CancellationToken::unsubscribe(size_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callbacks.erase(id);
+}
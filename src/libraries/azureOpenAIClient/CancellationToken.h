@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_CANCELLATIONTOKEN_H
+#define AZUREOPENAI_CANCELLATIONTOKEN_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace azureopenai {
+
+/**
+ * \brief Lets another thread abort a call in progress.
+ *
+ * The code performing the call either polls isCancelled() (e.g. between the
+ * chunks of a decoding loop) or subscribes a callback that aborts what it is
+ * waiting for (e.g. an HttpTransfer).
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken(CancellationToken&&) noexcept = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+    CancellationToken& operator=(CancellationToken&&) noexcept = delete;
+    ~CancellationToken() = default;
+
+    /**
+     * Cancel the call. The subscribed callbacks are called by this thread.
+     */
+    void cancel();
+    bool isCancelled() const;
+
+    /**
+     * Sleep for \p seconds, waking up early if the call is cancelled.
+     * @return true if the call was cancelled
+     */
+    bool waitFor(double seconds) const;
+
+    /**
+     * Register a callback called when the call is cancelled, or immediately if it is already.
+     * The callback must not block.
+     * @return an id for unsubscribe()
+     */
+    size_t subscribe(std::function<void()> callback);
+    void unsubscribe(size_t id);
+
+private:
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_cv;
+    bool m_cancelled{false};
+    std::map<size_t, std::function<void()>> m_callbacks;
+    size_t m_nextId{0};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_CANCELLATIONTOKEN_H
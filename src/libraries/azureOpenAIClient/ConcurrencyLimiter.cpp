@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ConcurrencyLimiter.h"
+
+#include "CancellationToken.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(CONCURRENCYLIMITER, "yarp.azureOpenAIClient.ConcurrencyLimiter")
+
+// Weight of the last sample in the moving average of the recent latency
+constexpr double recentAlpha = 0.2;
+// Speed at which the baseline follows a latency that stays higher (e.g. longer inputs)
+constexpr double baselineDrift = 0.01;
+constexpr double latencyBackoff = 0.9;
+constexpr double overloadBackoff = 0.5;
+} // namespace
+
+ConcurrencyLimiter::ConcurrencyLimiter(const ConcurrencyOptions& options) :
+        m_options(options)
+{
+    m_options.minLimit = std::max<size_t>(m_options.minLimit, 1);
+    m_options.maxLimit = std::max(m_options.maxLimit, m_options.minLimit);
+    m_limit = static_cast<double>(std::clamp(m_options.initialLimit, m_options.minLimit, m_options.maxLimit));
+}
+
+bool ConcurrencyLimiter::acquire(std::chrono::steady_clock::time_point deadline, const CancellationToken* cancellation)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t ticket = m_nextTicket++;
+    m_queue.push_back(ticket);
+
+    while (m_queue.front() != ticket || m_inFlight >= _allowed()) {
+        if (std::chrono::steady_clock::now() >= deadline || (cancellation && cancellation->isCancelled())) {
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), ticket));
+            lock.unlock();
+            // The next caller may be the first in the queue now
+            m_cv.notify_all();
+            return false;
+        }
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            m_cv.wait(lock);
+        } else {
+            m_cv.wait_until(lock, deadline);
+        }
+    }
+    m_queue.pop_front();
+    ++m_inFlight;
+    lock.unlock();
+    m_cv.notify_all();
+    return true;
+}
+
+void ConcurrencyLimiter::wakeUp()
+{
+    {
+        // Taken so that a caller about to wait does not miss the notification
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_cv.notify_all();
+}
+
+void ConcurrencyLimiter::release(Outcome outcome, double latency)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Growing the limit makes sense only if the current one is used, otherwise
+        // it would grow without bounds during the quiet periods
+        bool saturated = 2.0 * static_cast<double>(m_inFlight) >= m_limit;
+        --m_inFlight;
+        if (m_cooldown > 0) {
+            --m_cooldown;
+        }
+
+        if (outcome == Outcome::overload) {
+            _decrease(overloadBackoff, "the deployment is overloaded");
+        } else if (outcome == Outcome::success && latency >= 0.0) {
+            if (m_recentLatency < 0.0) {
+                m_recentLatency = m_baselineLatency = latency;
+            }
+            m_recentLatency += recentAlpha * (latency - m_recentLatency);
+            if (m_recentLatency < m_baselineLatency) {
+                m_baselineLatency = m_recentLatency;
+            } else {
+                m_baselineLatency += baselineDrift * (m_recentLatency - m_baselineLatency);
+            }
+
+            if (m_recentLatency > m_baselineLatency * m_options.latencyTolerance) {
+                _decrease(latencyBackoff, "the latency is growing");
+            } else if (saturated) {
+                // About one more request per round trip
+                m_limit = std::min(m_limit + 1.0 / m_limit, static_cast<double>(m_options.maxLimit));
+            }
+        }
+    }
+    m_cv.notify_all();
+}
+
+double ConcurrencyLimiter::limit() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limit;
+}
+
+size_t ConcurrencyLimiter::inFlight() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_inFlight;
+}
+
+size_t ConcurrencyLimiter::_allowed() const
+{
+    return std::max<size_t>(static_cast<size_t>(std::floor(m_limit)), 1);
+}
+
+void ConcurrencyLimiter::_decrease(double factor, const char* reason)
+{
+    if (m_cooldown > 0) {
+        return;
+    }
+    double limit = std::max(m_limit * factor, static_cast<double>(m_options.minLimit));
+    if (std::floor(limit) < std::floor(m_limit)) {
+        yCDebug(CONCURRENCYLIMITER) << "Requests in flight limited to" << std::floor(limit) << "since" << reason;
+    }
+    m_limit = limit;
+    m_cooldown = m_inFlight;
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_CONCURRENCYLIMITER_H
+#define AZUREOPENAI_CONCURRENCYLIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace azureopenai {
+
+class CancellationToken;
+
+/**
+ * \brief Options of the adaptive limit of the requests in flight.
+ */
+struct ConcurrencyOptions
+{
+    bool enabled{false};
+    size_t initialLimit{4};
+    size_t minLimit{1};
+    size_t maxLimit{64};
+    // Ratio between the recent and the baseline latency beyond which the limit is reduced
+    double latencyTolerance{2.0};
+};
+
+/**
+ * \brief Adaptive limit of the requests in flight (AIMD).
+ *
+ * While the latency stays close to the baseline (the latency observed with
+ * little load) and the limit is actually used, the limit grows by about one
+ * request per round trip. When the recent latency exceeds the baseline by
+ * more than the tolerance, the limit is reduced by 10%; when the deployment
+ * throttles (429, 503) or times out, it is halved. After a reduction the
+ * limit is not reduced again before the requests that were in flight at the
+ * time have completed, as they reflect the old limit. The callers waiting
+ * for a slot are served in order of arrival.
+ */
+class ConcurrencyLimiter
+{
+public:
+    enum class Outcome
+    {
+        // The request was answered, its latency is a valid sample
+        success,
+        // The deployment is overloaded (throttling, timeouts)
+        overload,
+        // The outcome says nothing about the load (cancellation, client errors...)
+        ignored
+    };
+
+    explicit ConcurrencyLimiter(const ConcurrencyOptions& options);
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter(ConcurrencyLimiter&&) noexcept = delete;
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter& operator=(ConcurrencyLimiter&&) noexcept = delete;
+    ~ConcurrencyLimiter() = default;
+
+    /**
+     * Block until the number of requests in flight is below the limit, and take a slot.
+     * @return false if no slot is available before \p deadline, or if
+     *         \p cancellation is cancelled while waiting (see wakeUp())
+     */
+    bool acquire(std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(), const CancellationToken* cancellation = nullptr);
+
+    /**
+     * Wake up the callers waiting in acquire(), so that they check their
+     * cancellation. It is subscribed to the CancellationToken of the call.
+     */
+    void wakeUp();
+
+    /**
+     * Give back the slot of a completed request, whose first byte arrived after \p latency seconds.
+     */
+    void release(Outcome outcome, double latency);
+
+    double limit() const;
+    size_t inFlight() const;
+
+private:
+    size_t _allowed() const;
+    void _decrease(double factor, const char* reason);
+
+    ConcurrencyOptions m_options;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    double m_limit;
+    size_t m_inFlight{0};
+    double m_baselineLatency{-1.0};
+    double m_recentLatency{-1.0};
+    // Completions to wait for before the limit can be reduced again
+    size_t m_cooldown{0};
+    std::deque<uint64_t> m_queue;
+    uint64_t m_nextTicket{0};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_CONCURRENCYLIMITER_H
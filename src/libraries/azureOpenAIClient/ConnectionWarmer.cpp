@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ConnectionWarmer.h"
+
+#include "HttpEngine.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Time.h>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(CONNECTIONWARMER, "yarp.azureOpenAIClient.ConnectionWarmer")
+
+constexpr double warmUpTimeout = 10.0; // seconds
+} // namespace
+
+class ConnectionWarmer::KeepAliveThread : public yarp::os::PeriodicThread
+{
+public:
+    KeepAliveThread(ConnectionWarmer& warmer, double period) :
+            yarp::os::PeriodicThread(period),
+            m_warmer(warmer),
+            m_period(period)
+    {
+    }
+
+    void run() override
+    {
+        // Ping only if no request went through the connection for a whole period
+        if (yarp::os::Time::now() - m_warmer.m_lastActivity >= m_period) {
+            m_warmer.warmUp();
+        }
+    }
+
+private:
+    ConnectionWarmer& m_warmer;
+    double m_period;
+};
+
+ConnectionWarmer::ConnectionWarmer(std::shared_ptr<IHttpTransport> transport, const std::string& url, const std::string& apiKey, const std::string& unixSocket, const std::vector<std::string>& headers,
+                                   long httpVersion) :
+        m_transport(std::move(transport)),
+        m_url(url),
+        m_unixSocket(unixSocket),
+        m_httpVersion(httpVersion),
+        m_hasApiKey(!apiKey.empty())
+{
+    if (m_hasApiKey) {
+        m_headers = curl_slist_append(m_headers, ("api-key: " + apiKey).c_str());
+    }
+    for (const auto& header : headers) {
+        m_headers = curl_slist_append(m_headers, header.c_str());
+    }
+}
+
+ConnectionWarmer::~ConnectionWarmer()
+{
+    stopKeepAlive();
+    curl_slist_free_all(m_headers);
+}
+
+bool ConnectionWarmer::warmUp()
+{
+    if (!m_transport) {
+        return false;
+    }
+
+    auto request = std::make_shared<HttpRequest>();
+    request->url = m_url;
+    request->headers = m_headers;
+    request->head = true;
+    request->httpVersion = m_httpVersion;
+    request->unixSocket = m_unixSocket;
+    // A HEAD response has no body, so no time-to-first-byte timeout
+    request->timeouts.connect = warmUpTimeout;
+    request->timeouts.total = warmUpTimeout;
+    HttpResponse response = m_transport->submit(std::move(request))->wait();
+    m_lastActivity = yarp::os::Time::now();
+    if (response.result != CURLE_OK) {
+        yCError(CONNECTIONWARMER) << "Unable to reach" << m_url << ":" << curl_easy_strerror(response.result);
+        return false;
+    }
+
+    // Any answer means that the connection is up, the HEAD request itself is not a valid API call
+    if (m_hasApiKey && (response.status == 401 || response.status == 403)) {
+        yCWarning(CONNECTIONWARMER) << "The endpoint rejected the API key (HTTP" << response.status << ")";
+    }
+    yCDebug(CONNECTIONWARMER) << "Connection warm, HTTP" << response.status << "version:" << response.httpVersion << "time:" << response.totalTime << "s";
+
+    return true;
+}
+
+void ConnectionWarmer::notifyActivity()
+{
+    m_lastActivity = yarp::os::Time::now();
+}
+
+bool ConnectionWarmer::startKeepAlive(double period)
+{
+    stopKeepAlive();
+    if (period <= 0.0) {
+        return true;
+    }
+    m_keepAlive = std::make_unique<KeepAliveThread>(*this, period);
+    if (!m_keepAlive->start()) {
+        yCError(CONNECTIONWARMER) << "Failed to start the keep-alive thread";
+        m_keepAlive.reset();
+        return false;
+    }
+    return true;
+}
+
+void ConnectionWarmer::stopKeepAlive()
+{
+    if (m_keepAlive) {
+        m_keepAlive->stop();
+        m_keepAlive.reset();
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_CONNECTIONWARMER_H
+#define AZUREOPENAI_CONNECTIONWARMER_H
+
+#include <curl/curl.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IHttpTransport.h"
+
+namespace azureopenai {
+
+/**
+ * \brief Keeps the connection to an endpoint warm.
+ *
+ * warmUp() sends a lightweight HEAD request to the endpoint through the
+ * \p transport (the HttpEngine), which resolves the host, completes the TLS
+ * handshake and leaves the connection in the pool that serves the requests.
+ * The optional keep-alive thread repeats it whenever the device has been
+ * idle for a whole period, so that the server does not close the connection.
+ * If \p unixSocket is not empty, the connection is made to that Unix domain
+ * socket (see the azureOpenAIGateway) instead of the host of the url. The
+ * \p headers are sent along with the api-key, if \p apiKey is not empty: the
+ * connection is warmed up also when the server rejects the request. The
+ * \p httpVersion must be the one of the requests, for them to reuse the warm
+ * connection.
+ */
+class ConnectionWarmer
+{
+public:
+    ConnectionWarmer(std::shared_ptr<IHttpTransport> transport, const std::string& url, const std::string& apiKey, const std::string& unixSocket = {}, const std::vector<std::string>& headers = {},
+                     long httpVersion = CURL_HTTP_VERSION_2TLS);
+    ConnectionWarmer(const ConnectionWarmer&) = delete;
+    ConnectionWarmer(ConnectionWarmer&&) noexcept = delete;
+    ConnectionWarmer& operator=(const ConnectionWarmer&) = delete;
+    ConnectionWarmer& operator=(ConnectionWarmer&&) noexcept = delete;
+    ~ConnectionWarmer();
+
+    /**
+     * Connect to the endpoint and check that it answers.
+     * @return false if the endpoint could not be reached
+     */
+    bool warmUp();
+
+    /**
+     * Record that a request has just been sent on the connection.
+     */
+    void notifyActivity();
+
+    /**
+     * Start pinging the endpoint after every \p period seconds of inactivity.
+     */
+    bool startKeepAlive(double period);
+    void stopKeepAlive();
+
+private:
+    class KeepAliveThread;
+
+    std::shared_ptr<IHttpTransport> m_transport;
+    std::string m_url;
+    std::string m_unixSocket;
+    long m_httpVersion;
+    bool m_hasApiKey;
+    struct curl_slist* m_headers{nullptr};
+    std::atomic<double> m_lastActivity{0.0};
+    std::unique_ptr<KeepAliveThread> m_keepAlive;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_CONNECTIONWARMER_H
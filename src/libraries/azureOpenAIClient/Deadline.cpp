@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Deadline.h"
+
+#include <algorithm>
+
+using namespace azureopenai;
+
+namespace {
+thread_local std::chrono::steady_clock::time_point t_deadline{std::chrono::steady_clock::time_point::max()};
+} // namespace
+
+DeadlineScope::DeadlineScope(double seconds) :
+        DeadlineScope(fromNow(seconds))
+{
+}
+
+DeadlineScope::DeadlineScope(std::chrono::steady_clock::time_point deadline) :
+        m_previous(t_deadline)
+{
+    // A nested scope cannot extend the deadline of the enclosing one
+    t_deadline = std::min(m_previous, deadline);
+}
+
+DeadlineScope::~DeadlineScope()
+{
+    t_deadline = m_previous;
+}
+
+std::chrono::steady_clock::time_point DeadlineScope::current()
+{
+    return t_deadline;
+}
+
+std::chrono::steady_clock::time_point DeadlineScope::fromNow(double seconds)
+{
+    if (seconds <= 0.0) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_DEADLINE_H
+#define AZUREOPENAI_DEADLINE_H
+
+#include <chrono>
+
+namespace azureopenai {
+
+/**
+ * \brief Sets the deadline of the requests made by the current thread.
+ *
+ * The device interfaces have no room for a deadline, so a caller of the same
+ * process that has a latency budget opens a scope around the call, e.g.
+ * \code
+ * #include <azureopenai/Deadline.h>
+ * {
+ *     azureopenai::DeadlineScope deadline(1.5);
+ *     transcriber->transcribe(sound, text, score);
+ * }
+ * \endcode
+ * The scope is per thread, so it does not reach the devices called through
+ * a YARP port: they use the TIMEOUTS::deadline parameter instead.
+ * Scopes can be nested, a nested scope can only shorten the deadline.
+ */
+class DeadlineScope
+{
+public:
+    explicit DeadlineScope(double seconds);
+    explicit DeadlineScope(std::chrono::steady_clock::time_point deadline);
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope(DeadlineScope&&) noexcept = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(DeadlineScope&&) noexcept = delete;
+    ~DeadlineScope();
+
+    /**
+     * The earliest deadline of the scopes of this thread, std::chrono::steady_clock::time_point::max() if there is none.
+     */
+    static std::chrono::steady_clock::time_point current();
+
+    /**
+     * The deadline \p seconds from now, or std::chrono::steady_clock::time_point::max() if \p seconds is not positive.
+     */
+    static std::chrono::steady_clock::time_point fromNow(double seconds);
+
+private:
+    std::chrono::steady_clock::time_point m_previous;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_DEADLINE_H
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "EndpointPool.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <limits>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(ENDPOINTPOOL, "yarp.azureOpenAIClient.EndpointPool")
+
+// Added to the score of a deployment for each consecutive failure [s]
+constexpr double failurePenalty = 2.0;
+} // namespace
+
+EndpointPool::EndpointPool(double ewmaAlpha, double exploration) :
+        m_ewmaAlpha(ewmaAlpha),
+        m_exploration(exploration),
+        m_random(std::random_device{}())
+{
+}
+
+EndpointPool::~EndpointPool()
+{
+    for (auto& entry : m_entries) {
+        curl_slist_free_all(entry.headers);
+    }
+}
+
+size_t EndpointPool::add(const std::string& name, const std::string& url, const std::vector<std::string>& headers)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry entry;
+    entry.name = name;
+    for (const auto& header : headers) {
+        entry.headers = curl_slist_append(entry.headers, header.c_str());
+    }
+    entry.target = {url, entry.headers};
+    m_entries.push_back(std::move(entry));
+    return m_entries.size() - 1;
+}
+
+void EndpointPool::setCircuitBreaker(const CircuitBreakerOptions& options)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_breaker = options;
+}
+
+size_t EndpointPool::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+const std::string& EndpointPool::name(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.at(index).name;
+}
+
+const HttpTarget& EndpointPool::target(size_t index) const
+{
+    // Entries are added only during the configuration, their targets do not change afterwards
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.at(index).target;
+}
+
+size_t EndpointPool::select()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (m_entries.size() > 1 && std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_exploration) {
+        size_t index = std::uniform_int_distribution<size_t>(0, m_entries.size() - 1)(m_random);
+        if (_isAvailable(m_entries[index], now)) {
+            return _admit(index);
+        }
+    }
+    return _admit(_best(none, now));
+}
+
+size_t EndpointPool::selectAlternative(size_t exclude)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t index = _best(exclude, std::chrono::steady_clock::now());
+    return _admit(index);
+}
+
+bool EndpointPool::isProbing(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.at(index).circuit == Circuit::halfOpen;
+}
+
+void EndpointPool::reportSuccess(size_t index, double latency)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries.at(index);
+    if (latency >= 0.0) {
+        entry.ewma = entry.hasSamples ? m_ewmaAlpha * latency + (1.0 - m_ewmaAlpha) * entry.ewma : latency;
+        entry.hasSamples = true;
+    }
+    entry.consecutiveFailures = 0;
+    if (entry.circuit != Circuit::closed) {
+        yCInfo(ENDPOINTPOOL) << "Deployment" << entry.name << "is answering again, circuit closed";
+        entry.circuit = Circuit::closed;
+    }
+}
+
+void EndpointPool::reportFailure(size_t index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries.at(index);
+    entry.consecutiveFailures++;
+    if (m_entries.size() > 1) {
+        yCDebug(ENDPOINTPOOL) << "Deployment" << entry.name << "failed" << entry.consecutiveFailures << "times in a row";
+    }
+    bool trip = (entry.circuit == Circuit::halfOpen) || (m_breaker.failureThreshold > 0 && entry.consecutiveFailures >= m_breaker.failureThreshold);
+    if (trip) {
+        if (entry.circuit == Circuit::closed) {
+            yCWarning(ENDPOINTPOOL) << "Deployment" << entry.name << "failed" << entry.consecutiveFailures << "times in a row, circuit open for" << m_breaker.cooldown << "s";
+        }
+        entry.circuit = Circuit::open;
+        entry.openedAt = std::chrono::steady_clock::now();
+    }
+}
+
+void EndpointPool::reportCancelled(size_t index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries.at(index);
+    if (entry.circuit == Circuit::halfOpen) {
+        // The probe did not complete, let another request probe the deployment
+        entry.circuit = Circuit::open;
+    }
+}
+
+double EndpointPool::_score(const Entry& entry) const
+{
+    // Deployments never measured have score 0, so that they are tried first
+    return entry.ewma + failurePenalty * entry.consecutiveFailures;
+}
+
+bool EndpointPool::_isAvailable(const Entry& entry, std::chrono::steady_clock::time_point now) const
+{
+    switch (entry.circuit) {
+    case Circuit::closed:
+        return true;
+    case Circuit::open:
+        return std::chrono::duration<double>(now - entry.openedAt).count() >= m_breaker.cooldown;
+    case Circuit::halfOpen:
+        // A probe is already in flight
+        return false;
+    }
+    return false;
+}
+
+size_t EndpointPool::_admit(size_t index)
+{
+    if (index != none && m_entries[index].circuit == Circuit::open) {
+        yCDebug(ENDPOINTPOOL) << "Probing deployment" << m_entries[index].name;
+        m_entries[index].circuit = Circuit::halfOpen;
+    }
+    return index;
+}
+
+size_t EndpointPool::_best(size_t exclude, std::chrono::steady_clock::time_point now) const
+{
+    size_t best = none;
+    double bestScore = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (i == exclude || !_isAvailable(m_entries[i], now)) {
+            continue;
+        }
+        double score = _score(m_entries[i]);
+        if (score < bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best;
+}
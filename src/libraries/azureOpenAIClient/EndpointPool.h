@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_ENDPOINTPOOL_H
+#define AZUREOPENAI_ENDPOINTPOOL_H
+
+#include <curl/curl.h>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "HttpRequest.h"
+
+namespace azureopenai {
+
+/**
+ * \brief Options of the circuit breaker of each deployment.
+ *
+ * After \p failureThreshold consecutive failures the circuit opens and the
+ * deployment is not used for \p cooldown seconds. Then a single request is
+ * let through as a probe: if it succeeds the circuit closes, otherwise it
+ * opens again for another cooldown.
+ */
+struct CircuitBreakerOptions
+{
+    // 0 disables the circuit breaker
+    unsigned int failureThreshold{5};
+    double cooldown{10.0};
+};
+
+/**
+ * \brief A set of equivalent deployments, possibly in different regions.
+ *
+ * Each request is routed to the healthy deployment with the lowest recent
+ * latency, estimated with an exponentially weighted moving average (EWMA).
+ * Deployments without samples are tried first, and a small fraction of the
+ * requests is sent to a random deployment to keep the estimates up to date.
+ * Deployments whose circuit breaker is open are skipped.
+ */
+class EndpointPool
+{
+public:
+    EndpointPool(double ewmaAlpha = 0.2, double exploration = 0.05);
+    EndpointPool(const EndpointPool&) = delete;
+    EndpointPool(EndpointPool&&) noexcept = delete;
+    EndpointPool& operator=(const EndpointPool&) = delete;
+    EndpointPool& operator=(EndpointPool&&) noexcept = delete;
+    ~EndpointPool();
+
+    /**
+     * Add a deployment. \p headers must include the API key of the deployment.
+     * @return the index of the new deployment
+     */
+    size_t add(const std::string& name, const std::string& url, const std::vector<std::string>& headers);
+
+    void setCircuitBreaker(const CircuitBreakerOptions& options);
+
+    size_t size() const;
+    const std::string& name(size_t index) const;
+    const HttpTarget& target(size_t index) const;
+
+    static constexpr size_t none = static_cast<size_t>(-1);
+
+    /**
+     * The deployment that should serve the next request, or \ref none if
+     * the circuit breakers of all the deployments are open.
+     * The selection admits the request, so it must be followed by one of the report methods.
+     */
+    size_t select();
+
+    /**
+     * The best available deployment other than \p exclude, or \ref none if there is none.
+     * Like select(), a deployment returned is admitted.
+     */
+    size_t selectAlternative(size_t exclude);
+
+    /**
+     * Whether the request admitted to deployment \p index is the probe of its circuit breaker.
+     */
+    bool isProbing(size_t index) const;
+
+    /**
+     * The deployment answered. \p latency is negative if it should not be used
+     * to estimate the latency (e.g. the request was rejected with a 4xx status).
+     */
+    void reportSuccess(size_t index, double latency);
+    void reportFailure(size_t index);
+
+    /**
+     * The request was cancelled, it tells nothing about the deployment.
+     */
+    void reportCancelled(size_t index);
+
+private:
+    enum class Circuit
+    {
+        closed,
+        open,
+        halfOpen
+    };
+
+    struct Entry
+    {
+        std::string name;
+        HttpTarget target;
+        struct curl_slist* headers{nullptr};
+        double ewma{0.0};
+        bool hasSamples{false};
+        unsigned int consecutiveFailures{0};
+        Circuit circuit{Circuit::closed};
+        std::chrono::steady_clock::time_point openedAt;
+    };
+
+    double _score(const Entry& entry) const;
+    bool _isAvailable(const Entry& entry, std::chrono::steady_clock::time_point now) const;
+    size_t _admit(size_t index);
+    size_t _best(size_t exclude, std::chrono::steady_clock::time_point now) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    double m_ewmaAlpha;
+    double m_exploration;
+    CircuitBreakerOptions m_breaker;
+    std::mt19937 m_random;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_ENDPOINTPOOL_H
@@ -0,0 +1,273 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "FakeHttpTransport.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(FAKEHTTPTRANSPORT, "yarp.azureOpenAIClient.FakeHttpTransport")
+
+// Granularity of the bandwidth emulation
+constexpr auto chunkPeriod = std::chrono::milliseconds(10);
+
+// MPEG-1 Layer III, 128 kbit/s, 44100 Hz, mono, no CRC, no padding
+constexpr unsigned char mp3FrameHeader[] = {0xFF, 0xFB, 0x90, 0xC0};
+constexpr size_t mp3FrameSize = 144 * 128000 / 44100;
+constexpr size_t mp3FrameSamples = 1152;
+constexpr double mp3SampleRate = 44100.0;
+
+// Format of the pcm and wav responses of the service
+constexpr uint32_t pcmSampleRate = 24000;
+constexpr uint32_t pcmBytesPerSample = 2;
+
+void appendLittleEndian(std::string& data, uint32_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        data += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+const std::string cannedText = "This is a canned transcription.";
+} // namespace
+
+FakeHttpTransport::FakeHttpTransport(const FakeHttpOptions& options) :
+        m_options(options),
+        m_speech(std::make_shared<const std::string>(silentMp3(options.speechDuration))),
+        m_speechPcm(std::make_shared<const std::string>(silentPcm(options.speechDuration))),
+        m_speechWav(std::make_shared<const std::string>(silentPcm(options.speechDuration, true))),
+        m_transcription(std::make_shared<const std::string>(verboseJsonTranscription(cannedText, 1.0))),
+        m_body(std::make_shared<const std::string>(options.body)),
+        m_notFound(std::make_shared<const std::string>(R"({"error": {"code": "404", "message": "Resource not found"}})"))
+{
+    if (!start()) {
+        yCError(FAKEHTTPTRANSPORT) << "Failed to start the fake transport thread";
+    }
+}
+
+FakeHttpTransport::~FakeHttpTransport()
+{
+    if (isRunning()) {
+        stop();
+    }
+}
+
+std::shared_ptr<HttpTransfer> FakeHttpTransport::submit(std::shared_ptr<const HttpRequest> request, std::function<void()> listener, const HttpTarget& target)
+{
+    auto transfer = std::make_shared<HttpTransfer>(std::move(request), target);
+    transfer->setListener(std::move(listener));
+    transfer->m_submitTime = std::chrono::steady_clock::now();
+    if (!isRunning()) {
+        transfer->m_response.result = CURLE_FAILED_INIT;
+        transfer->_complete();
+        return transfer;
+    }
+
+    Pending pending;
+    pending.transfer = transfer;
+    const std::string& url = transfer->m_target.url;
+    if (!m_options.body.empty()) {
+        pending.body = m_body;
+    } else if (url.find("/audio/speech") != std::string::npos) {
+        std::string format = speechFormat(transfer->m_request->body);
+        if (format == "mp3" || format == "pcm" || format == "wav") {
+            pending.body = format == "pcm" ? m_speechPcm : format == "wav" ? m_speechWav : m_speech;
+        } else {
+            yCWarning(FAKEHTTPTRANSPORT) << "No canned speech in the" << format << "format";
+            pending.status = 400;
+            pending.body = std::make_shared<const std::string>(R"({"error": {"code": "400", "message": "No canned speech in the )" + format + R"( format"}})");
+        }
+    } else if (url.find("/audio/transcriptions") != std::string::npos) {
+        pending.body = m_transcription;
+    } else {
+        pending.status = 404;
+        pending.body = m_notFound;
+    }
+    pending.firstByteAt = transfer->m_submitTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_options.latency));
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::move(pending));
+    }
+    m_cv.notify_all();
+    return transfer;
+}
+
+void FakeHttpTransport::cancel(const std::shared_ptr<HttpTransfer>& transfer)
+{
+    if (!transfer || transfer->isDone()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled.insert(transfer);
+    }
+    m_cv.notify_all();
+}
+
+std::string FakeHttpTransport::silentMp3(double seconds)
+{
+    // Frames with empty side information and no main data decode to silence
+    auto frames = static_cast<size_t>(std::ceil(std::max(seconds, 0.0) * mp3SampleRate / mp3FrameSamples));
+    std::string frame(mp3FrameSize, '\0');
+    std::copy(std::begin(mp3FrameHeader), std::end(mp3FrameHeader), frame.begin());
+    std::string mp3;
+    mp3.reserve(frames * mp3FrameSize);
+    for (size_t i = 0; i < frames; ++i) {
+        mp3 += frame;
+    }
+    return mp3;
+}
+
+std::string FakeHttpTransport::silentPcm(double seconds, bool wav)
+{
+    auto samples = static_cast<uint32_t>(std::ceil(std::max(seconds, 0.0) * pcmSampleRate));
+    uint32_t dataSize = samples * pcmBytesPerSample;
+    std::string pcm;
+    if (wav) {
+        pcm.reserve(44 + dataSize);
+        pcm += "RIFF";
+        appendLittleEndian(pcm, 36 + dataSize, 4);
+        pcm += "WAVEfmt ";
+        appendLittleEndian(pcm, 16, 4);
+        appendLittleEndian(pcm, 1, 2); // PCM
+        appendLittleEndian(pcm, 1, 2); // channels
+        appendLittleEndian(pcm, pcmSampleRate, 4);
+        appendLittleEndian(pcm, pcmSampleRate * pcmBytesPerSample, 4);
+        appendLittleEndian(pcm, pcmBytesPerSample, 2);
+        appendLittleEndian(pcm, 8 * pcmBytesPerSample, 2);
+        pcm += "data";
+        appendLittleEndian(pcm, dataSize, 4);
+    }
+    pcm.append(dataSize, '\0');
+    return pcm;
+}
+
+std::string FakeHttpTransport::speechFormat(const std::string& requestBody)
+{
+    auto json = nlohmann::json::parse(requestBody, nullptr, false);
+    if (json.is_object()) {
+        auto format = json.find("response_format");
+        if (format != json.end() && format->is_string()) {
+            return format->get<std::string>();
+        }
+    }
+    return "mp3";
+}
+
+std::string FakeHttpTransport::verboseJsonTranscription(const std::string& text, double duration)
+{
+    std::ostringstream json;
+    json << R"({"task": "transcribe", "language": "english", "duration": )" << duration
+         << R"(, "text": ")" << text
+         << R"(", "segments": [{"id": 0, "seek": 0, "start": 0.0, "end": )" << duration
+         << R"(, "text": ")" << text
+         << R"(", "avg_logprob": -0.2, "compression_ratio": 1.0, "no_speech_prob": 0.01}]})";
+    return json.str();
+}
+
+void FakeHttpTransport::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!isStopping()) {
+        auto now = std::chrono::steady_clock::now();
+        auto wakeUp = now + std::chrono::seconds(1);
+
+        std::vector<Delivery> deliveries;
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            Delivery delivery;
+            delivery.transfer = it->transfer;
+            if (m_cancelled.erase(it->transfer) > 0) {
+                delivery.result = CURLE_ABORTED_BY_CALLBACK;
+            } else if (now >= it->transfer->m_request->deadline) {
+                delivery.result = CURLE_OPERATION_TIMEDOUT;
+            } else if (now >= it->firstByteAt) {
+                const std::string& body = *it->body;
+                size_t end = body.size();
+                if (m_options.bandwidth > 0.0) {
+                    double elapsed = std::chrono::duration<double>(now - it->firstByteAt).count();
+                    end = std::min(body.size(), std::max(it->sent + 1, static_cast<size_t>(elapsed * m_options.bandwidth)));
+                }
+                delivery.status = it->status;
+                delivery.data = body.data() + it->sent;
+                delivery.size = end - it->sent;
+                delivery.body = it->body;
+                it->sent = end;
+                if (end < body.size()) {
+                    deliveries.push_back(std::move(delivery));
+                    wakeUp = std::min(wakeUp, now + chunkPeriod);
+                    ++it;
+                    continue;
+                }
+            } else {
+                wakeUp = std::min(wakeUp, it->firstByteAt);
+                ++it;
+                continue;
+            }
+            delivery.done = true;
+            deliveries.push_back(std::move(delivery));
+            it = m_pending.erase(it);
+        }
+        m_cancelled.clear();
+
+        // The listeners may cancel other transfers, so they are called without holding the lock
+        lock.unlock();
+        for (const auto& delivery : deliveries) {
+            _deliver(delivery);
+        }
+        lock.lock();
+
+        if (!isStopping()) {
+            m_cv.wait_until(lock, wakeUp);
+        }
+    }
+
+    // Nobody is waiting anymore, but do not leave the transfers hanging
+    std::vector<Pending> pending;
+    pending.swap(m_pending);
+    lock.unlock();
+    for (auto& p : pending) {
+        p.transfer->m_response.result = CURLE_ABORTED_BY_CALLBACK;
+        p.transfer->_complete();
+    }
+}
+
+void FakeHttpTransport::onStop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cv.notify_all();
+}
+
+void FakeHttpTransport::_deliver(const Delivery& delivery)
+{
+    HttpTransfer& transfer = *delivery.transfer;
+    HttpResponse& response = transfer.m_response;
+    if (delivery.result != CURLE_OK) {
+        response.result = delivery.result;
+        response.deadlineExceeded = (delivery.result == CURLE_OPERATION_TIMEDOUT);
+        transfer._complete();
+        return;
+    }
+
+    if (delivery.size > 0) {
+        transfer._receive(delivery.data, delivery.size, delivery.status);
+    }
+    if (delivery.done) {
+        response.status = delivery.status;
+        response.totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - transfer.m_submitTime).count();
+        response.httpVersion = CURL_HTTP_VERSION_2_0;
+        transfer._complete();
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_FAKEHTTPTRANSPORT_H
+#define AZUREOPENAI_FAKEHTTPTRANSPORT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+
+#include "HttpEngine.h"
+#include "IHttpTransport.h"
+
+namespace azureopenai {
+
+/**
+ * \brief Options of the FakeHttpTransport.
+ */
+struct FakeHttpOptions
+{
+    // Time between the submission and the first byte of the response [s]
+    double latency{0.3};
+    // Download speed of the response body, 0 for unlimited [bytes/s]
+    double bandwidth{0.0};
+    // If not empty, the body of every response, instead of the canned ones
+    std::string body;
+    // Duration of the canned speech [s]
+    double speechDuration{3.0};
+};
+
+/**
+ * \brief In-process transport serving canned responses, no network involved.
+ *
+ * Requests to .../audio/speech get a silent MP3 (or pcm and wav, if they
+ * ask for that response_format; there is no canned speech in the other
+ * formats, they get a 400), requests to
+ * .../audio/transcriptions get a verbose_json transcription, anything else a
+ * 404. The responses are delivered by a thread of the transport, with the
+ * configured latency and bandwidth, so that the whole client pipeline
+ * (policies, decoding) can be benchmarked offline. Cancellations and
+ * deadlines are honored like in the HttpEngine.
+ */
+class FakeHttpTransport :
+        public IHttpTransport,
+        private yarp::os::Thread
+{
+public:
+    explicit FakeHttpTransport(const FakeHttpOptions& options = {});
+    FakeHttpTransport(const FakeHttpTransport&) = delete;
+    FakeHttpTransport(FakeHttpTransport&&) noexcept = delete;
+    FakeHttpTransport& operator=(const FakeHttpTransport&) = delete;
+    FakeHttpTransport& operator=(FakeHttpTransport&&) noexcept = delete;
+    ~FakeHttpTransport() override;
+
+    // IHttpTransport
+    std::shared_ptr<HttpTransfer> submit(std::shared_ptr<const HttpRequest> request, std::function<void()> listener = {}, const HttpTarget& target = {}) override;
+    void cancel(const std::shared_ptr<HttpTransfer>& transfer) override;
+
+    /**
+     * An MPEG-1 Layer III stream of \p seconds of silence (44.1 kHz, mono, 128 kbit/s).
+     */
+    static std::string silentMp3(double seconds);
+
+    /**
+     * \p seconds of silence as 16 bit little endian samples (24 kHz, mono),
+     * with a wav header if \p wav is true, like the pcm and wav responses of the service.
+     */
+    static std::string silentPcm(double seconds, bool wav = false);
+
+    /**
+     * The response_format of the JSON body of a speech request, mp3 if it is not specified.
+     */
+    static std::string speechFormat(const std::string& requestBody);
+
+    /**
+     * A transcription in the verbose_json format of the Azure OpenAI APIs.
+     */
+    static std::string verboseJsonTranscription(const std::string& text, double duration);
+
+private:
+    struct Pending
+    {
+        std::shared_ptr<HttpTransfer> transfer;
+        long status{200};
+        std::shared_ptr<const std::string> body;
+        std::chrono::steady_clock::time_point firstByteAt;
+        size_t sent{0};
+    };
+
+    // What the transport thread does to a transfer at one iteration
+    struct Delivery
+    {
+        std::shared_ptr<HttpTransfer> transfer;
+        CURLcode result{CURLE_OK};
+        long status{200};
+        // A chunk of the body, kept alive by body
+        std::shared_ptr<const std::string> body;
+        const char* data{nullptr};
+        size_t size{0};
+        bool done{false};
+    };
+
+    // yarp::os::Thread
+    void run() override;
+    void onStop() override;
+
+    static void _deliver(const Delivery& delivery);
+
+    FakeHttpOptions m_options;
+    std::shared_ptr<const std::string> m_speech;
+    std::shared_ptr<const std::string> m_speechPcm;
+    std::shared_ptr<const std::string> m_speechWav;
+    std::shared_ptr<const std::string> m_transcription;
+    std::shared_ptr<const std::string> m_body;
+    std::shared_ptr<const std::string> m_notFound;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Pending> m_pending;
+    std::set<std::shared_ptr<HttpTransfer>> m_cancelled;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_FAKEHTTPTRANSPORT_H
@@ -0,0 +1,375 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "HttpClient.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(HTTPCLIENT, "yarp.azureOpenAIClient.HttpClient")
+
+// Number of samples needed before trusting the latency percentile
+constexpr size_t minLatencySamples = 20;
+
+double randomUniform(double min, double max)
+{
+    thread_local std::mt19937 generator(std::random_device{}());
+    return std::uniform_real_distribution<double>(min, max)(generator);
+}
+
+HttpResponse cancelledResponse()
+{
+    HttpResponse response;
+    response.result = CURLE_ABORTED_BY_CALLBACK;
+    return response;
+}
+
+HttpResponse deadlineExceededResponse()
+{
+    HttpResponse response;
+    response.result = CURLE_OPERATION_TIMEDOUT;
+    response.deadlineExceeded = true;
+    return response;
+}
+
+bool isCancelled(const HttpRequest& request)
+{
+    return request.cancellation && request.cancellation->isCancelled();
+}
+
+ConcurrencyLimiter::Outcome concurrencyOutcome(const HttpResponse& response)
+{
+    if (response.ok()) {
+        return ConcurrencyLimiter::Outcome::success;
+    }
+    if (response.status == 429 || response.status == 503 || (response.result == CURLE_OPERATION_TIMEDOUT && !response.deadlineExceeded)) {
+        return ConcurrencyLimiter::Outcome::overload;
+    }
+    return ConcurrencyLimiter::Outcome::ignored;
+}
+
+std::string describeFailure(const HttpResponse& response)
+{
+    if (response.result != CURLE_OK) {
+        return curl_easy_strerror(response.result);
+    }
+    return "HTTP status " + std::to_string(response.status);
+}
+} // namespace
+
+HttpClient::HttpClient(std::shared_ptr<IHttpTransport> transport) :
+        m_transport(std::move(transport))
+{
+}
+
+void HttpClient::setEndpoints(std::shared_ptr<EndpointPool> endpoints)
+{
+    m_endpoints = std::move(endpoints);
+}
+
+void HttpClient::setHedging(const HedgingOptions& options, const HttpTarget& target)
+{
+    m_hedging = options;
+    m_hedgeTarget = target;
+}
+
+void HttpClient::setRetry(const RetryOptions& options)
+{
+    m_retry = options;
+}
+
+void HttpClient::setRateLimiter(std::shared_ptr<RateLimiter> limiter)
+{
+    m_limiter = std::move(limiter);
+}
+
+void HttpClient::setConcurrencyLimiter(std::shared_ptr<ConcurrencyLimiter> limiter)
+{
+    m_concurrency = std::move(limiter);
+}
+
+HttpResponse HttpClient::perform(HttpRequest request)
+{
+    auto sharedRequest = std::make_shared<const HttpRequest>(std::move(request));
+    // A cancellation must also interrupt the wait for the quota and for a slot
+    bool waits = m_limiter || m_concurrency;
+    size_t subscription = 0;
+    if (sharedRequest->cancellation && waits) {
+        subscription = sharedRequest->cancellation->subscribe([limiter = m_limiter, concurrency = m_concurrency]() {
+            if (limiter) {
+                limiter->wakeUp();
+            }
+            if (concurrency) {
+                concurrency->wakeUp();
+            }
+        });
+    }
+    HttpResponse response = _performRetrying(sharedRequest);
+    if (sharedRequest->cancellation && waits) {
+        sharedRequest->cancellation->unsubscribe(subscription);
+    }
+    return response;
+}
+
+HttpResponse HttpClient::_performRetrying(const std::shared_ptr<const HttpRequest>& sharedRequest)
+{
+    double waited = 0.0;
+    for (unsigned int retry = 0;; ++retry) {
+        if (m_limiter && !m_limiter->acquire(sharedRequest->quotaUnits, sharedRequest->deadline, sharedRequest->cancellation.get())) {
+            if (isCancelled(*sharedRequest)) {
+                return cancelledResponse();
+            }
+            yCWarning(HTTPCLIENT) << "No quota available before the deadline of the request";
+            return deadlineExceededResponse();
+        }
+        if (m_concurrency && !m_concurrency->acquire(sharedRequest->deadline, sharedRequest->cancellation.get())) {
+            if (isCancelled(*sharedRequest)) {
+                return cancelledResponse();
+            }
+            yCWarning(HTTPCLIENT) << "Too many requests in flight to send the request before its deadline";
+            return deadlineExceededResponse();
+        }
+        if (isCancelled(*sharedRequest) || std::chrono::steady_clock::now() >= sharedRequest->deadline) {
+            if (m_concurrency) {
+                m_concurrency->release(ConcurrencyLimiter::Outcome::ignored, -1.0);
+            }
+            return isCancelled(*sharedRequest) ? cancelledResponse() : deadlineExceededResponse();
+        }
+        HttpResponse response = _performOnce(sharedRequest);
+        if (m_concurrency) {
+            m_concurrency->release(concurrencyOutcome(response), response.timeToFirstByte >= 0.0 ? response.timeToFirstByte : response.totalTime);
+        }
+        if (response.ok() || !response.isRetryable() || retry >= m_retry.maxRetries) {
+            return response;
+        }
+        double delay = _retryDelay(retry, response);
+        if (waited + delay > m_retry.budget) {
+            yCWarning(HTTPCLIENT) << "Request failed (" << describeFailure(response) << "), retry budget exhausted";
+            return response;
+        }
+        if (std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(delay)) >= sharedRequest->deadline) {
+            yCWarning(HTTPCLIENT) << "Request failed (" << describeFailure(response) << "), no time left for a retry before the deadline";
+            return response;
+        }
+        yCWarning(HTTPCLIENT) << "Request failed (" << describeFailure(response) << "), retrying in" << delay << "s";
+        if (sharedRequest->cancellation) {
+            if (sharedRequest->cancellation->waitFor(delay)) {
+                return cancelledResponse();
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+        }
+        waited += delay;
+    }
+}
+
+double HttpClient::_retryDelay(unsigned int retry, const HttpResponse& response) const
+{
+    if (response.retryAfter >= 0.0) {
+        // Spread the callers that were throttled together, so that they do not come back all at once
+        return response.retryAfter * randomUniform(1.0, 1.2);
+    }
+    // "Full jitter" exponential backoff
+    double backoff = std::min(m_retry.maxBackoff, m_retry.initialBackoff * std::pow(2.0, retry));
+    return randomUniform(0.0, backoff);
+}
+
+HttpResponse HttpClient::_performOnce(const std::shared_ptr<const HttpRequest>& sharedRequest)
+{
+    size_t endpoint = EndpointPool::none;
+    if (m_endpoints && m_endpoints->size() > 0) {
+        endpoint = m_endpoints->select();
+        if (endpoint == EndpointPool::none) {
+            yCError(HTTPCLIENT) << "The circuit breakers of all the deployments are open, request not sent";
+            HttpResponse response;
+            response.result = CURLE_COULDNT_CONNECT;
+            response.circuitOpen = true;
+            return response;
+        }
+    }
+    if (m_hedging.enabled) {
+        return _performHedged(sharedRequest, endpoint);
+    }
+
+    auto transfer = m_transport->submit(sharedRequest, {}, _target(endpoint));
+    HttpResponse response = _wait(transfer, *sharedRequest);
+    response.endpoint = endpoint;
+    _recordFirstByte(*transfer);
+    _report(endpoint, *transfer);
+    return response;
+}
+
+HttpResponse HttpClient::_performHedged(const std::shared_ptr<const HttpRequest>& request, size_t endpoint)
+{
+    // The transport thread wakes up the caller whenever one of the transfers starts
+    // answering or completes. The lock is taken to avoid missing a notification.
+    struct Race
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto race = std::make_shared<Race>();
+    auto listener = [race]() {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->cv.notify_all();
+    };
+
+    double delay = _hedgeDelay();
+    std::vector<std::shared_ptr<HttpTransfer>> transfers;
+    std::vector<size_t> endpoints;
+    transfers.push_back(m_transport->submit(request, listener, _target(endpoint)));
+    endpoints.push_back(endpoint);
+    auto hedgeTime = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(delay));
+
+    size_t subscription = 0;
+    if (request->cancellation) {
+        subscription = request->cancellation->subscribe(listener);
+    }
+
+    std::shared_ptr<HttpTransfer> winner;
+    // The circuit breaker lets a single probe through, a duplicate must not reach a deployment being probed
+    bool hedgeAllowed = (endpoint == EndpointPool::none) || !m_endpoints->isProbing(endpoint);
+    std::unique_lock<std::mutex> lock(race->mutex);
+    while (!isCancelled(*request)) {
+        bool allDone = true;
+        for (const auto& transfer : transfers) {
+            if (transfer->isAnswering()) {
+                winner = transfer;
+                break;
+            }
+            allDone = allDone && transfer->isDone();
+        }
+        if (winner || allDone) {
+            break;
+        }
+
+        if (transfers.size() == 1 && hedgeAllowed) {
+            if (race->cv.wait_until(lock, hedgeTime) == std::cv_status::timeout) {
+                size_t hedgeEndpoint = EndpointPool::none;
+                HttpTarget hedgeTarget = m_hedgeTarget;
+                if (hedgeTarget.url.empty() && endpoint != EndpointPool::none) {
+                    // Selected only now, since the selection admits the request through the circuit breaker
+                    hedgeEndpoint = m_endpoints->selectAlternative(endpoint);
+                    // Without another deployment the duplicate goes to the same one, whose health is
+                    // reported only once, through the original request
+                    hedgeTarget = _target(hedgeEndpoint != EndpointPool::none ? hedgeEndpoint : endpoint);
+                }
+                if (m_limiter && !m_limiter->tryAcquire(request->quotaUnits)) {
+                    // A duplicate would push the deployment over its quota
+                    if (hedgeEndpoint != EndpointPool::none) {
+                        m_endpoints->reportCancelled(hedgeEndpoint);
+                    }
+                    hedgeAllowed = false;
+                    continue;
+                }
+                yCDebug(HTTPCLIENT) << "No answer after" << delay << "s, sending a hedged request";
+                // submit() may call the listener, which takes the lock
+                lock.unlock();
+                transfers.push_back(m_transport->submit(request, listener, hedgeTarget));
+                endpoints.push_back(hedgeEndpoint);
+                lock.lock();
+            }
+        } else {
+            race->cv.wait(lock);
+        }
+    }
+    lock.unlock();
+    if (request->cancellation) {
+        request->cancellation->unsubscribe(subscription);
+    }
+
+    if (isCancelled(*request)) {
+        winner = transfers.front();
+        m_transport->cancel(winner);
+    } else if (!winner) {
+        // Everything failed, report the error of the original request
+        winner = transfers.front();
+    } else if (winner != transfers.front()) {
+        yCDebug(HTTPCLIENT) << "The hedged request answered first";
+    }
+    for (const auto& transfer : transfers) {
+        if (transfer != winner) {
+            m_transport->cancel(transfer);
+        }
+    }
+
+    HttpResponse response = _wait(winner, *request);
+    _recordFirstByte(*winner);
+    for (size_t i = 0; i < transfers.size(); ++i) {
+        if (transfers[i] == winner) {
+            // A duplicate sent to the same deployment has no index of its own, one sent to the hedge target has none
+            bool sameDeployment = endpoints[i] == EndpointPool::none && m_hedgeTarget.url.empty();
+            response.endpoint = sameDeployment ? endpoint : endpoints[i];
+        }
+        _report(endpoints[i], *transfers[i]);
+    }
+    return response;
+}
+
+HttpResponse HttpClient::_wait(const std::shared_ptr<HttpTransfer>& transfer, const HttpRequest& request)
+{
+    if (!request.cancellation) {
+        return transfer->wait();
+    }
+    size_t subscription = request.cancellation->subscribe([transport = m_transport, transfer]() { transport->cancel(transfer); });
+    HttpResponse response = transfer->wait();
+    request.cancellation->unsubscribe(subscription);
+    return response;
+}
+
+HttpTarget HttpClient::_target(size_t endpoint) const
+{
+    // An empty target makes the transport use the url of the request
+    return (endpoint != EndpointPool::none) ? m_endpoints->target(endpoint) : HttpTarget{};
+}
+
+double HttpClient::_hedgeDelay() const
+{
+    double delay = m_hedging.defaultDelay;
+    if (m_firstByteLatency.size() >= minLatencySamples) {
+        m_firstByteLatency.percentile(m_hedging.quantile, delay);
+    }
+    return std::max(delay, m_hedging.minDelay);
+}
+
+void HttpClient::_report(size_t endpoint, HttpTransfer& transfer)
+{
+    if (endpoint == EndpointPool::none) {
+        return;
+    }
+    const HttpResponse& response = transfer.wait();
+    if (response.ok()) {
+        double ttfb = transfer.timeToFirstByte();
+        m_endpoints->reportSuccess(endpoint, ttfb >= 0.0 ? ttfb : response.totalTime);
+    } else if (response.result == CURLE_ABORTED_BY_CALLBACK || response.result == CURLE_FAILED_INIT || response.deadlineExceeded) {
+        // The deployment is not to blame for a cancellation or for the deadline chosen by the caller
+        m_endpoints->reportCancelled(endpoint);
+    } else if (response.isRetryable()) {
+        m_endpoints->reportFailure(endpoint);
+    } else {
+        // Most client errors (4xx) are caused by the request, but the deployment is answering
+        m_endpoints->reportSuccess(endpoint, -1.0);
+    }
+}
+
+void HttpClient::_recordFirstByte(const HttpTransfer& transfer)
+{
+    double ttfb = transfer.timeToFirstByte();
+    if (ttfb >= 0.0) {
+        m_firstByteLatency.addSample(ttfb);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_HTTPCLIENT_H
+#define AZUREOPENAI_HTTPCLIENT_H
+
+#include <memory>
+
+#include "ConcurrencyLimiter.h"
+#include "EndpointPool.h"
+#include "HttpEngine.h"
+#include "HttpRequest.h"
+#include "IHttpTransport.h"
+#include "LatencyTracker.h"
+#include "RateLimiter.h"
+
+namespace azureopenai {
+
+/**
+ * \brief Options of the hedged requests.
+ *
+ * When enabled, if a request has not started answering after the \p quantile
+ * of the recently observed time-to-first-byte, a duplicate is sent and the
+ * first one to answer is used, while the other is cancelled.
+ */
+struct HedgingOptions
+{
+    bool enabled{false};
+    double quantile{0.95};
+    // Lower bound of the hedging delay [s]
+    double minDelay{0.2};
+    // Hedging delay used until enough latency samples are collected [s]
+    double defaultDelay{1.0};
+};
+
+/**
+ * \brief Options of the retries of the failed requests.
+ *
+ * Only the failures that may be transient (see HttpResponse::isRetryable())
+ * are retried. The client waits for the delay requested by the server if any,
+ * otherwise for a random time up to an exponentially growing backoff.
+ */
+struct RetryOptions
+{
+    // Retries after the first attempt, 0 disables them
+    unsigned int maxRetries{3};
+    // Upper bound of the wait before the first retry, doubled at each retry [s]
+    double initialBackoff{0.5};
+    double maxBackoff{8.0};
+    // Maximum total wait before the retries of a single call [s]
+    double budget{10.0};
+};
+
+/**
+ * \brief The request path used by a device.
+ *
+ * It sends the requests through a transport (normally the shared HttpEngine)
+ * and applies the per-device policies on top of it. If an EndpointPool is set,
+ * each request is routed to the deployment selected by the pool, otherwise to
+ * the url of the request.
+ */
+class HttpClient
+{
+public:
+    explicit HttpClient(std::shared_ptr<IHttpTransport> transport);
+    HttpClient(const HttpClient&) = delete;
+    HttpClient(HttpClient&&) noexcept = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+    HttpClient& operator=(HttpClient&&) noexcept = delete;
+    ~HttpClient() = default;
+
+    void setEndpoints(std::shared_ptr<EndpointPool> endpoints);
+
+    /**
+     * Enable the hedged requests. The duplicates are sent to \p target or, if
+     * the target url is empty, to the second best deployment of the pool
+     * (or to the same one, if there is only one).
+     */
+    void setHedging(const HedgingOptions& options, const HttpTarget& target = {});
+
+    void setRetry(const RetryOptions& options);
+
+    /**
+     * Every attempt (retries and hedged duplicates included) waits for the budget of the limiter.
+     * Hedged duplicates are not sent if the budget is not available immediately.
+     */
+    void setRateLimiter(std::shared_ptr<RateLimiter> limiter);
+
+    /**
+     * Every attempt (retries included) waits for a slot of the limiter, after
+     * the budget of the rate limiter. Hedged duplicates do not take a slot.
+     */
+    void setConcurrencyLimiter(std::shared_ptr<ConcurrencyLimiter> limiter);
+
+    /**
+     * Send the request and wait for its response, retrying the transient failures.
+     * No retry is attempted if it could not start before the deadline of the request.
+     */
+    HttpResponse perform(HttpRequest request);
+
+private:
+    HttpResponse _performRetrying(const std::shared_ptr<const HttpRequest>& sharedRequest);
+    HttpResponse _performOnce(const std::shared_ptr<const HttpRequest>& sharedRequest);
+    double _retryDelay(unsigned int retry, const HttpResponse& response) const;
+    HttpResponse _performHedged(const std::shared_ptr<const HttpRequest>& request, size_t endpoint);
+    HttpResponse _wait(const std::shared_ptr<HttpTransfer>& transfer, const HttpRequest& request);
+    HttpTarget _target(size_t endpoint) const;
+    double _hedgeDelay() const;
+    void _recordFirstByte(const HttpTransfer& transfer);
+    void _report(size_t endpoint, HttpTransfer& transfer);
+
+    std::shared_ptr<IHttpTransport> m_transport;
+    std::shared_ptr<EndpointPool> m_endpoints;
+    std::shared_ptr<RateLimiter> m_limiter;
+    std::shared_ptr<ConcurrencyLimiter> m_concurrency;
+    RetryOptions m_retry;
+    HedgingOptions m_hedging;
+    HttpTarget m_hedgeTarget;
+    LatencyTracker m_firstByteLatency;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_HTTPCLIENT_H
@@ -0,0 +1,642 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "HttpEngine.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(HTTPENGINE, "yarp.azureOpenAIClient.HttpEngine")
+
+constexpr int pollTimeoutMs = 100;
+constexpr size_t maxIdleHandles = 16;
+constexpr long maxConcurrentStreams = 100;
+
+std::mutex s_instanceMutex;
+HttpEngine* s_instance{nullptr};
+size_t s_users{0};
+
+// Streams a form part straight from the request, instead of letting
+// curl_mime_data() copy it (audio uploads can be several megabytes)
+struct MimeSource
+{
+    const std::string* data;
+    size_t offset{0};
+};
+
+size_t mimeRead(char* buffer, size_t size, size_t nitems, void* arg)
+{
+    auto* source = static_cast<MimeSource*>(arg);
+    size_t len = std::min(size * nitems, source->data->size() - source->offset);
+    std::copy_n(source->data->data() + source->offset, len, buffer);
+    source->offset += len;
+    return len;
+}
+
+int mimeSeek(void* arg, curl_off_t offset, int origin)
+{
+    auto* source = static_cast<MimeSource*>(arg);
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > source->data->size()) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    source->offset = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+void mimeFree(void* arg)
+{
+    delete static_cast<MimeSource*>(arg);
+}
+
+std::string trim(const std::string& value)
+{
+    size_t first = value.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return {};
+    }
+    return value.substr(first, value.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+bool parseSeconds(const std::string& value, double& seconds)
+{
+    char* end = nullptr;
+    seconds = std::strtod(value.c_str(), &end);
+    return end != value.c_str() && *end == '\0' && seconds >= 0.0;
+}
+
+// Parses the durations of the x-ratelimit-reset-* headers, e.g. "20ms", "1s" or "6m0s"
+bool parseDuration(const std::string& value, double& seconds)
+{
+    if (parseSeconds(value, seconds)) {
+        return true;
+    }
+    seconds = 0.0;
+    const char* cursor = value.c_str();
+    while (*cursor != '\0') {
+        char* end = nullptr;
+        double amount = std::strtod(cursor, &end);
+        if (end == cursor || amount < 0.0) {
+            return false;
+        }
+        std::string unit;
+        while (*end != '\0' && std::isalpha(static_cast<unsigned char>(*end))) {
+            unit += *end++;
+        }
+        if (unit == "ms") {
+            seconds += amount / 1000.0;
+        } else if (unit == "s") {
+            seconds += amount;
+        } else if (unit == "m") {
+            seconds += amount * 60.0;
+        } else if (unit == "h") {
+            seconds += amount * 3600.0;
+        } else {
+            return false;
+        }
+        cursor = end;
+    }
+    return true;
+}
+} // namespace
+
+
+HttpTransfer::HttpTransfer(std::shared_ptr<const HttpRequest> request, HttpTarget target) :
+        m_request(std::move(request)),
+        m_target(std::move(target))
+{
+    if (m_target.url.empty()) {
+        m_target = {m_request->url, m_request->headers};
+    }
+}
+
+const HttpResponse& HttpTransfer::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_done; });
+    return m_response;
+}
+
+bool HttpTransfer::isDone() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_done;
+}
+
+bool HttpTransfer::isAnswering() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_answering;
+}
+
+double HttpTransfer::timeToFirstByte() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timeToFirstByte;
+}
+
+void HttpTransfer::setListener(std::function<void()> listener)
+{
+    m_listener = std::move(listener);
+}
+
+void HttpTransfer::_complete()
+{
+    m_response.timeToFirstByte = m_timeToFirstByte;
+    if (m_request->stream) {
+        if (m_streaming) {
+            m_request->stream->complete(this, m_response.ok());
+        } else if (m_response.ok() && m_request->stream->claim(this, m_response.contentType)) {
+            // Another transfer was writing the stream when this one started answering
+            m_request->stream->write(this, m_response.body.data(), m_response.body.size());
+            m_request->stream->complete(this, true);
+            m_response.body.clear();
+        }
+    }
+    if (m_retryAfterMs >= 0.0) {
+        m_response.retryAfter = m_retryAfterMs;
+    } else if (m_retryAfter >= 0.0) {
+        m_response.retryAfter = m_retryAfter;
+    } else {
+        m_response.retryAfter = m_rateLimitReset;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+        if (m_response.ok()) {
+            m_answering = true;
+        }
+    }
+    m_cv.notify_all();
+    _notify();
+}
+
+void HttpTransfer::_notify()
+{
+    if (m_listener) {
+        m_listener();
+    }
+}
+
+void HttpTransfer::_receive(const char* data, size_t size, long status)
+{
+    if (m_timeToFirstByte < 0.0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_timeToFirstByte = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_submitTime).count();
+            m_answering = status >= 200 && status < 300;
+        }
+        m_streaming = m_request->stream && status >= 200 && status < 300 && m_request->stream->claim(this, m_response.contentType);
+        _notify();
+    }
+    if (m_streaming) {
+        m_request->stream->write(this, data, size);
+    } else {
+        m_response.body.append(data, size);
+    }
+}
+
+size_t HttpTransfer::_writeCallback(char* contents, size_t size, size_t nmemb, void* userdata)
+{
+    auto* transfer = static_cast<HttpTransfer*>(userdata);
+    size_t totalSize = size * nmemb;
+    long status = 0;
+    if (transfer->m_timeToFirstByte < 0.0) {
+        curl_easy_getinfo(transfer->m_curl, CURLINFO_RESPONSE_CODE, &status);
+    }
+    transfer->_receive(contents, totalSize, status);
+    return totalSize;
+}
+
+size_t HttpTransfer::_headerCallback(char* buffer, size_t size, size_t nitems, void* userdata)
+{
+    auto* transfer = static_cast<HttpTransfer*>(userdata);
+    size_t totalSize = size * nitems;
+    std::string line(buffer, totalSize);
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        // A new response starts (e.g. after a 100 Continue), forget the previous headers
+        transfer->m_retryAfterMs = transfer->m_retryAfter = transfer->m_rateLimitReset = -1.0;
+        transfer->m_response.contentType.clear();
+        return totalSize;
+    }
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+        return totalSize;
+    }
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::string value = trim(line.substr(colon + 1));
+
+    double seconds = 0.0;
+    if (name == "content-type") {
+        transfer->m_response.contentType = value;
+    } else if (name == "retry-after-ms") {
+        if (parseSeconds(value, seconds)) {
+            transfer->m_retryAfterMs = seconds / 1000.0;
+        }
+    } else if (name == "retry-after") {
+        // Either a number of seconds or an HTTP date
+        if (parseSeconds(value, seconds)) {
+            transfer->m_retryAfter = seconds;
+        } else {
+            time_t date = curl_getdate(value.c_str(), nullptr);
+            if (date >= 0) {
+                transfer->m_retryAfter = std::max(0.0, std::difftime(date, std::time(nullptr)));
+            }
+        }
+    } else if (name == "x-ratelimit-reset-requests" || name == "x-ratelimit-reset-tokens") {
+        if (parseDuration(value, seconds)) {
+            transfer->m_rateLimitReset = std::max(transfer->m_rateLimitReset, seconds);
+        }
+    }
+    return totalSize;
+}
+
+int HttpTransfer::_progressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    auto* transfer = static_cast<HttpTransfer*>(clientp);
+    if (std::chrono::steady_clock::now() >= transfer->m_request->deadline) {
+        // Makes the transfer complete with CURLE_ABORTED_BY_CALLBACK
+        transfer->m_response.deadlineExceeded = true;
+        return 1;
+    }
+    return 0;
+}
+
+
+HttpEngine::HttpEngine() :
+        m_state(SharedHttpState::acquire())
+{
+    m_multi = curl_multi_init();
+    if (!m_multi) {
+        yCError(HTTPENGINE) << "Failed to initialize the cURL multi handle";
+        return;
+    }
+    // Concurrent HTTP/2 requests to the same host share a single connection
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_CONCURRENT_STREAMS, maxConcurrentStreams);
+    if (!(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        yCWarning(HTTPENGINE) << "libcurl was built without HTTP/2 support, requests will not be multiplexed";
+    }
+
+    if (!start()) {
+        yCError(HTTPENGINE) << "Failed to start the HTTP engine thread";
+    }
+}
+
+HttpEngine::~HttpEngine()
+{
+    if (isRunning()) {
+        stop();
+    }
+    for (CURL* curl : m_idleHandles) {
+        curl_easy_cleanup(curl);
+    }
+    if (m_multi) {
+        curl_multi_cleanup(m_multi);
+    }
+}
+
+std::shared_ptr<HttpEngine> HttpEngine::acquire()
+{
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (!s_instance) {
+        s_instance = new HttpEngine();
+    }
+    s_users++;
+
+    return std::shared_ptr<HttpEngine>(s_instance, [](HttpEngine*) {
+        std::lock_guard<std::mutex> lock(s_instanceMutex);
+        if (--s_users == 0) {
+            delete s_instance;
+            s_instance = nullptr;
+        }
+    });
+}
+
+std::shared_ptr<HttpTransfer> HttpEngine::submit(HttpRequest request)
+{
+    return submit(std::make_shared<const HttpRequest>(std::move(request)));
+}
+
+std::shared_ptr<HttpTransfer> HttpEngine::submit(std::shared_ptr<const HttpRequest> request, std::function<void()> listener, const HttpTarget& target)
+{
+    auto transfer = std::make_shared<HttpTransfer>(std::move(request), target);
+    transfer->setListener(std::move(listener));
+    transfer->m_submitTime = std::chrono::steady_clock::now();
+    if (!isRunning()) {
+        transfer->m_response.result = CURLE_FAILED_INIT;
+        transfer->_complete();
+        return transfer;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.push_back(transfer);
+    }
+    curl_multi_wakeup(m_multi);
+    return transfer;
+}
+
+void HttpEngine::cancel(const std::shared_ptr<HttpTransfer>& transfer)
+{
+    if (!transfer || transfer->isDone()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_cancelled.push_back(transfer);
+    }
+    curl_multi_wakeup(m_multi);
+}
+
+HttpResponse HttpEngine::perform(HttpRequest request)
+{
+    return submit(std::move(request))->wait();
+}
+
+bool HttpEngine::httpVersionFromString(const std::string& name, long& version)
+{
+    if (name == "1.1") {
+        version = CURL_HTTP_VERSION_1_1;
+    } else if (name == "2") {
+        version = CURL_HTTP_VERSION_2TLS;
+    } else if (name == "3") {
+        version = CURL_HTTP_VERSION_2TLS;
+#if LIBCURL_VERSION_NUM >= 0x075800
+        // Since 7.88 libcurl races a TCP connection against QUIC, and uses it with
+        // HTTP/2 or 1.1 if the endpoint does not answer over HTTP/3 (e.g. UDP blocked)
+        if ((curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP3) != 0) {
+            version = CURL_HTTP_VERSION_3;
+        }
+#endif
+        if (version != CURL_HTTP_VERSION_3) {
+            yCWarning(HTTPENGINE) << "libcurl" << curl_version_info(CURLVERSION_NOW)->version << "has no HTTP/3 support, using HTTP/2";
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void HttpEngine::run()
+{
+    while (!isStopping()) {
+        _startPending();
+        _abortCancelled();
+        _abortLate();
+
+        int running = 0;
+        CURLMcode mres = curl_multi_perform(m_multi, &running);
+        if (mres != CURLM_OK) {
+            yCError(HTTPENGINE) << "curl_multi_perform failed:" << curl_multi_strerror(mres);
+        }
+        _collectCompleted();
+
+        // Sleeps until there is socket activity, a wakeup from submit() or the timeout
+        curl_multi_poll(m_multi, nullptr, 0, pollTimeoutMs, nullptr);
+    }
+
+    // Nobody is waiting anymore, but do not leave the transfers hanging
+    std::deque<std::shared_ptr<HttpTransfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+        m_cancelled.clear();
+    }
+    for (auto& [curl, transfer] : m_active) {
+        curl_multi_remove_handle(m_multi, curl);
+        curl_easy_cleanup(curl);
+        curl_mime_free(transfer->m_mime);
+        transfer->m_mime = nullptr;
+        transfer->m_curl = nullptr;
+        pending.push_back(transfer);
+    }
+    m_active.clear();
+    for (auto& transfer : pending) {
+        transfer->m_response.result = CURLE_ABORTED_BY_CALLBACK;
+        transfer->_complete();
+    }
+}
+
+void HttpEngine::onStop()
+{
+    curl_multi_wakeup(m_multi);
+}
+
+void HttpEngine::_startPending()
+{
+    std::deque<std::shared_ptr<HttpTransfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+    }
+
+    for (auto& transfer : pending) {
+        if (!_configure(*transfer)) {
+            transfer->m_response.result = CURLE_FAILED_INIT;
+            transfer->_complete();
+            continue;
+        }
+        CURLMcode mres = curl_multi_add_handle(m_multi, transfer->m_curl);
+        if (mres != CURLM_OK) {
+            yCError(HTTPENGINE) << "curl_multi_add_handle failed:" << curl_multi_strerror(mres);
+            _recycle(transfer->m_curl);
+            transfer->m_curl = nullptr;
+            curl_mime_free(transfer->m_mime);
+            transfer->m_mime = nullptr;
+            transfer->m_response.result = CURLE_FAILED_INIT;
+            transfer->_complete();
+            continue;
+        }
+        m_active[transfer->m_curl] = transfer;
+    }
+}
+
+void HttpEngine::_abortCancelled()
+{
+    std::vector<std::shared_ptr<HttpTransfer>> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        cancelled.swap(m_cancelled);
+    }
+
+    for (auto& transfer : cancelled) {
+        _abort(transfer, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+void HttpEngine::_abortLate()
+{
+    // cURL has no time-to-first-byte timeout, it is checked here at every iteration of the loop.
+    // The progress callback checks the deadlines, but cURL calls it only about once per second
+    // while waiting for the server, so they are checked here too.
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<HttpTransfer>> late;
+    for (const auto& [curl, transfer] : m_active) {
+        double firstByte = transfer->m_request->timeouts.firstByte;
+        if (now >= transfer->m_request->deadline) {
+            transfer->m_response.deadlineExceeded = true;
+            late.push_back(transfer);
+        } else if (firstByte > 0.0 && transfer->timeToFirstByte() < 0.0 && std::chrono::duration<double>(now - transfer->m_submitTime).count() > firstByte) {
+            yCWarning(HTTPENGINE) << "No answer from" << transfer->m_target.url << "within" << firstByte << "s, request aborted";
+            late.push_back(transfer);
+        }
+    }
+    for (auto& transfer : late) {
+        _abort(transfer, CURLE_OPERATION_TIMEDOUT);
+    }
+}
+
+void HttpEngine::_abort(const std::shared_ptr<HttpTransfer>& transfer, CURLcode result)
+{
+    // Transfers are started before being aborted, so they can only be active or already completed
+    CURL* curl = transfer->m_curl;
+    auto it = m_active.find(curl);
+    if (!curl || it == m_active.end() || it->second != transfer) {
+        return;
+    }
+    m_active.erase(it);
+
+    // With HTTP/2 only the stream is reset, the connection stays in the pool
+    curl_multi_remove_handle(m_multi, curl);
+    _recycle(curl);
+    transfer->m_curl = nullptr;
+    curl_mime_free(transfer->m_mime);
+    transfer->m_mime = nullptr;
+
+    transfer->m_response.result = result;
+    transfer->_complete();
+}
+
+void HttpEngine::_collectCompleted()
+{
+    int left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(m_multi, &left)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL* curl = msg->easy_handle;
+        CURLcode result = msg->data.result;
+
+        auto it = m_active.find(curl);
+        if (it == m_active.end()) {
+            continue;
+        }
+        std::shared_ptr<HttpTransfer> transfer = it->second;
+        m_active.erase(it);
+
+        HttpResponse& response = transfer->m_response;
+        response.result = response.deadlineExceeded ? CURLE_OPERATION_TIMEDOUT : result;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &response.totalTime);
+        curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &response.httpVersion);
+        if (result == CURLE_OK && transfer->m_request->unixSocket.empty()) {
+            m_state->remember(curl);
+        }
+
+        curl_multi_remove_handle(m_multi, curl);
+        _recycle(curl);
+        transfer->m_curl = nullptr;
+        curl_mime_free(transfer->m_mime);
+        transfer->m_mime = nullptr;
+
+        transfer->_complete();
+    }
+}
+
+bool HttpEngine::_configure(HttpTransfer& transfer)
+{
+    CURL* curl = nullptr;
+    if (!m_idleHandles.empty()) {
+        curl = m_idleHandles.back();
+        m_idleHandles.pop_back();
+    } else {
+        curl = curl_easy_init();
+        if (!curl) {
+            yCError(HTTPENGINE) << "Failed to initialize cURL";
+            return false;
+        }
+    }
+    m_state->attach(curl);
+
+    const HttpRequest& request = *transfer.m_request;
+    curl_easy_setopt(curl, CURLOPT_URL, transfer.m_target.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.m_target.headers);
+    if (!request.parts.empty()) {
+        transfer.m_mime = curl_mime_init(curl);
+        for (const auto& part : request.parts) {
+            curl_mimepart* mimePart = curl_mime_addpart(transfer.m_mime);
+            curl_mime_name(mimePart, part.name.c_str());
+            curl_mime_data_cb(mimePart, static_cast<curl_off_t>(part.data.size()), mimeRead, mimeSeek, mimeFree, new MimeSource{&part.data});
+            if (!part.fileName.empty()) {
+                curl_mime_filename(mimePart, part.fileName.c_str());
+            }
+            if (!part.contentType.empty()) {
+                curl_mime_type(mimePart, part.contentType.c_str());
+            }
+        }
+        curl_easy_setopt(curl, CURLOPT_MIMEPOST, transfer.m_mime);
+    } else if (request.head) {
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.data());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, HttpTransfer::_writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HttpTransfer::_headerCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer);
+    if (request.deadline != std::chrono::steady_clock::time_point::max()) {
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, HttpTransfer::_progressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, request.httpVersion);
+    if (!request.unixSocket.empty()) {
+        curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, request.unixSocket.c_str());
+    }
+    const HttpTimeouts& timeouts = request.timeouts;
+    if (timeouts.connect > 0.0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(timeouts.connect * 1000.0));
+    }
+    if (timeouts.lowSpeedLimit > 0 && timeouts.lowSpeedTime > 0.0) {
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, timeouts.lowSpeedLimit);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, static_cast<long>(std::ceil(timeouts.lowSpeedTime)));
+    }
+    if (timeouts.total > 0.0) {
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeouts.total * 1000.0));
+    }
+    if (request.httpVersion != CURL_HTTP_VERSION_1_1 && transfer.m_target.url.compare(0, 8, "https://") == 0) {
+        // Wait for a connection being set up to tell (through ALPN) if it can be multiplexed,
+        // instead of opening a new one for every concurrent request. On plain http this
+        // would be known only after the first response, serializing the requests.
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    }
+
+    transfer.m_curl = curl;
+    return true;
+}
+
+void HttpEngine::_recycle(CURL* curl)
+{
+    // curl_easy_reset() keeps the handle caches, but drops all the options (including the share)
+    curl_easy_reset(curl);
+    if (m_idleHandles.size() < maxIdleHandles) {
+        m_idleHandles.push_back(curl);
+    } else {
+        curl_easy_cleanup(curl);
+    }
+}
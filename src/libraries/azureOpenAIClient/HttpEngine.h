@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_HTTPENGINE_H
+#define AZUREOPENAI_HTTPENGINE_H
+
+#include <curl/curl.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+
+#include "HttpRequest.h"
+#include "IHttpTransport.h"
+#include "SharedHttpState.h"
+
+namespace azureopenai {
+
+class HttpEngine;
+
+/**
+ * \brief A request submitted to the HttpEngine.
+ * It is shared between the caller, which waits for it, and the engine thread, which performs it.
+ */
+class HttpTransfer
+{
+public:
+    HttpTransfer(std::shared_ptr<const HttpRequest> request, HttpTarget target);
+    HttpTransfer(const HttpTransfer&) = delete;
+    HttpTransfer(HttpTransfer&&) noexcept = delete;
+    HttpTransfer& operator=(const HttpTransfer&) = delete;
+    HttpTransfer& operator=(HttpTransfer&&) noexcept = delete;
+    ~HttpTransfer() = default;
+
+    /**
+     * Block until the transfer is completed.
+     */
+    const HttpResponse& wait();
+    bool isDone() const;
+
+    /**
+     * True once the server has started sending a successful (2xx) response.
+     */
+    bool isAnswering() const;
+
+    /**
+     * Seconds between the submission and the first byte of the response body, negative if not received yet.
+     */
+    double timeToFirstByte() const;
+
+    /**
+     * Set a function called by the engine thread when the first byte arrives and when the transfer completes.
+     * It must be set before the transfer is submitted, and it must not block.
+     */
+    void setListener(std::function<void()> listener);
+
+private:
+    friend class HttpEngine;
+    friend class FakeHttpTransport;
+
+    void _complete();
+    void _notify();
+    // Append a chunk of the response body, the first one marks the first byte
+    void _receive(const char* data, size_t size, long status);
+    static size_t _writeCallback(char* contents, size_t size, size_t nmemb, void* userdata);
+    static size_t _headerCallback(char* buffer, size_t size, size_t nitems, void* userdata);
+    static int _progressCallback(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+
+    std::shared_ptr<const HttpRequest> m_request;
+    HttpTarget m_target;
+    HttpResponse m_response;
+    CURL* m_curl{nullptr};
+    curl_mime* m_mime{nullptr};
+    std::function<void()> m_listener;
+    std::chrono::steady_clock::time_point m_submitTime;
+    // Retry hints, in order of precedence [s]
+    double m_retryAfterMs{-1.0};
+    double m_retryAfter{-1.0};
+    double m_rateLimitReset{-1.0};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_done{false};
+    bool m_answering{false};
+    double m_timeToFirstByte{-1.0};
+    // This transfer writes the body to HttpRequest::stream
+    bool m_streaming{false};
+};
+
+/**
+ * \brief Process-wide asynchronous HTTP engine.
+ *
+ * A single thread drives all the transfers of the process through a curl_multi
+ * handle, so that many requests coming from different devices and different
+ * RPC threads run concurrently without a thread per request. The multi handle
+ * owns the connection pool of the process: every transfer that should reuse a
+ * warm connection (including the warm-ups) must go through the engine. Easy
+ * handles are recycled between transfers and attached to the SharedHttpState,
+ * which shares the DNS and TLS session caches.
+ *
+ * Like SharedHttpState, the engine is created by the first acquire() and
+ * stopped when the last user releases it.
+ */
+class HttpEngine :
+        public IHttpTransport,
+        private yarp::os::Thread
+{
+public:
+    HttpEngine(const HttpEngine&) = delete;
+    HttpEngine(HttpEngine&&) noexcept = delete;
+    HttpEngine& operator=(const HttpEngine&) = delete;
+    HttpEngine& operator=(HttpEngine&&) noexcept = delete;
+    ~HttpEngine() override;
+
+    static std::shared_ptr<HttpEngine> acquire();
+
+    /**
+     * Queue a request. The call returns immediately, use HttpTransfer::wait() to get the response.
+     */
+    std::shared_ptr<HttpTransfer> submit(HttpRequest request);
+
+    // IHttpTransport
+    std::shared_ptr<HttpTransfer> submit(std::shared_ptr<const HttpRequest> request, std::function<void()> listener = {}, const HttpTarget& target = {}) override;
+    /**
+     * The transfers exceeding their HttpTimeouts complete with CURLE_OPERATION_TIMEDOUT instead of being cancelled.
+     */
+    void cancel(const std::shared_ptr<HttpTransfer>& transfer) override;
+
+    /**
+     * Queue a request and wait for its response.
+     */
+    HttpResponse perform(HttpRequest request);
+
+    /**
+     * Convert a version string ("1.1", "2" or "3") to the corresponding CURL_HTTP_VERSION_* value.
+     * HTTP/3 falls back to HTTP/2 if libcurl was built without it.
+     */
+    static bool httpVersionFromString(const std::string& name, long& version);
+
+private:
+    HttpEngine();
+
+    // yarp::os::Thread
+    void run() override;
+    void onStop() override;
+
+    void _startPending();
+    void _abortCancelled();
+    void _abortLate();
+    void _abort(const std::shared_ptr<HttpTransfer>& transfer, CURLcode result);
+    void _collectCompleted();
+    bool _configure(HttpTransfer& transfer);
+    void _recycle(CURL* curl);
+
+    std::shared_ptr<SharedHttpState> m_state;
+    CURLM* m_multi{nullptr};
+
+    std::mutex m_pendingMutex;
+    std::deque<std::shared_ptr<HttpTransfer>> m_pending;
+    std::vector<std::shared_ptr<HttpTransfer>> m_cancelled;
+
+    // Accessed only by the engine thread
+    std::map<CURL*, std::shared_ptr<HttpTransfer>> m_active;
+    std::vector<CURL*> m_idleHandles;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_HTTPENGINE_H
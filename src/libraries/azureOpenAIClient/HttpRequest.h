@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_HTTPREQUEST_H
+#define AZUREOPENAI_HTTPREQUEST_H
+
+#include <curl/curl.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "StreamingBody.h"
+
+namespace azureopenai {
+
+/**
+ * \brief One part of a multipart/form-data body.
+ * If fileName is not empty, the part is sent as a file upload.
+ */
+struct FormPart
+{
+    std::string name;
+    std::string data;
+    std::string fileName;
+    std::string contentType;
+};
+
+/**
+ * \brief Where a request is sent: the full URL and the headers (including the API key).
+ */
+struct HttpTarget
+{
+    std::string url;
+    // Not owned, it must outlive the transfer
+    const struct curl_slist* headers{nullptr};
+};
+
+/**
+ * \brief Timeouts enforced by the HttpEngine on each transfer, 0 disables them.
+ */
+struct HttpTimeouts
+{
+    // Time allowed to establish the connection (TLS handshake included) [s]
+    double connect{0.0};
+    // Time allowed between the submission and the first byte of the response body [s]
+    double firstByte{0.0};
+    // The transfer is aborted if it is slower than lowSpeedLimit bytes/s for lowSpeedTime seconds
+    long lowSpeedLimit{0};
+    double lowSpeedTime{0.0};
+    // Time allowed for the whole transfer [s]
+    double total{0.0};
+};
+
+/**
+ * \brief A POST (or HEAD) request to one of the azure openai endpoints.
+ * The body is either the raw \p body or, if \p parts is not empty, a multipart form.
+ */
+struct HttpRequest
+{
+    std::string url;
+    // Not owned, it must outlive the transfer
+    const struct curl_slist* headers{nullptr};
+    std::string body;
+    std::vector<FormPart> parts;
+    // One of the CURL_HTTP_VERSION_* values, HTTP/2 and HTTP/3 allow to multiplex concurrent requests
+    long httpVersion{CURL_HTTP_VERSION_2TLS};
+    HttpTimeouts timeouts;
+    // Units consumed from the quota of the deployment (see RateLimiter), e.g. characters or seconds of audio
+    double quotaUnits{0.0};
+    // Optional, cancelling it aborts the request, including its retries and hedged duplicates
+    std::shared_ptr<CancellationToken> cancellation;
+    // The request, including its queueing, retries and hedged duplicates, is abandoned at this time
+    std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::time_point::max()};
+    // If not empty, the connection is made to this Unix domain socket instead of the host of the url
+    std::string unixSocket;
+    // Optional, receives the body of the successful response while it is downloaded, instead of HttpResponse::body
+    std::shared_ptr<StreamingBody> stream;
+    // Send a HEAD request instead of the POST, e.g. to warm up the connection
+    bool head{false};
+};
+
+/**
+ * \brief The outcome of an HttpRequest.
+ * \p result reports transport errors, \p status the HTTP status code sent by the server.
+ */
+struct HttpResponse
+{
+    CURLcode result{CURLE_OK};
+    long status{0};
+    std::string body;
+    std::string contentType;
+    double totalTime{0.0};
+    // Time between sending the request and receiving the first byte of the body [s], negative if none
+    double timeToFirstByte{-1.0};
+    // The HTTP version actually negotiated with the server
+    long httpVersion{0};
+    // Delay requested by the server (Retry-After and similar headers) before retrying [s], negative if none
+    double retryAfter{-1.0};
+    // The request was not sent, because the circuit breakers of all the deployments are open
+    bool circuitOpen{false};
+    // The request was abandoned because its deadline expired, \p result is CURLE_OPERATION_TIMEDOUT
+    bool deadlineExceeded{false};
+    // Index in the EndpointPool of the deployment that answered, EndpointPool::none if there is no pool
+    size_t endpoint{static_cast<size_t>(-1)};
+
+    bool ok() const { return result == CURLE_OK && status >= 200 && status < 300; }
+
+    /**
+     * True if the same request may succeed if sent again: transport errors,
+     * throttling (429) and the transient server errors.
+     * Aborted transfers, the requests rejected by the circuit breaker and the
+     * ones past their deadline are not retryable.
+     */
+    bool isRetryable() const
+    {
+        if (circuitOpen || deadlineExceeded) {
+            return false;
+        }
+        if (result != CURLE_OK) {
+            return result != CURLE_ABORTED_BY_CALLBACK && result != CURLE_FAILED_INIT;
+        }
+        return status == 408 || status == 429 || status == 500 || status == 502 || status == 503 || status == 504;
+    }
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_HTTPREQUEST_H
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_IHTTPTRANSPORT_H
+#define AZUREOPENAI_IHTTPTRANSPORT_H
+
+#include <functional>
+#include <memory>
+
+#include "HttpRequest.h"
+
+namespace azureopenai {
+
+class HttpTransfer;
+
+/**
+ * \brief The layer that actually moves the bytes of the requests.
+ *
+ * HttpEngine implements it with libcurl, FakeHttpTransport serves canned
+ * responses in-process, to benchmark the client pipeline without network.
+ */
+class IHttpTransport
+{
+public:
+    virtual ~IHttpTransport() = default;
+
+    /**
+     * Queue a request that can be shared by several transfers (e.g. hedged duplicates).
+     * If \p target has an empty url, the request is sent to its own url and headers.
+     * The call returns immediately, use HttpTransfer::wait() to get the response.
+     */
+    virtual std::shared_ptr<HttpTransfer> submit(std::shared_ptr<const HttpRequest> request, std::function<void()> listener = {}, const HttpTarget& target = {}) = 0;
+
+    /**
+     * Abort a transfer. It completes with CURLE_ABORTED_BY_CALLBACK, unless it was already done.
+     */
+    virtual void cancel(const std::shared_ptr<HttpTransfer>& transfer) = 0;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_IHTTPTRANSPORT_H
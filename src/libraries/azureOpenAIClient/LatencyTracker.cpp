@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace azureopenai;
+
+LatencyTracker::LatencyTracker(size_t windowSize) :
+        m_windowSize(std::max<size_t>(windowSize, 1))
+{
+    m_samples.reserve(m_windowSize);
+}
+
+void LatencyTracker::addSample(double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_samples.size() < m_windowSize) {
+        m_samples.push_back(seconds);
+    } else {
+        m_samples[m_next] = seconds;
+    }
+    m_next = (m_next + 1) % m_windowSize;
+}
+
+size_t LatencyTracker::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_samples.size();
+}
+
+bool LatencyTracker::percentile(double quantile, double& value) const
+{
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        samples = m_samples;
+    }
+    if (samples.empty()) {
+        return false;
+    }
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    auto index = static_cast<size_t>(std::ceil(quantile * static_cast<double>(samples.size())));
+    index = std::clamp<size_t>(index, 1, samples.size()) - 1;
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    value = samples[index];
+    return true;
+}
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_LATENCYTRACKER_H
+#define AZUREOPENAI_LATENCYTRACKER_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace azureopenai {
+
+/**
+ * \brief Sliding window of latency samples, used to estimate their percentiles.
+ */
+class LatencyTracker
+{
+public:
+    explicit LatencyTracker(size_t windowSize = 200);
+
+    void addSample(double seconds);
+    size_t size() const;
+
+    /**
+     * The \p quantile (between 0 and 1) of the samples in the window.
+     * @return false if the window is empty
+     */
+    bool percentile(double quantile, double& value) const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<double> m_samples;
+    size_t m_windowSize;
+    size_t m_next{0};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_LATENCYTRACKER_H
@@ -0,0 +1,151 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "RateLimiter.h"
+
+#include "CancellationToken.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(RATELIMITER, "yarp.azureOpenAIClient.RateLimiter")
+
+// Waits shorter than this are not worth a log line [s]
+constexpr double reportedWait = 0.1;
+} // namespace
+
+RateLimiter::RateLimiter(double requestsPerMinute, double unitsPerMinute, double burst) :
+        m_lastRefill(std::chrono::steady_clock::now())
+{
+    for (auto [bucket, perMinute] : {std::make_pair(&m_requests, requestsPerMinute), std::make_pair(&m_units, unitsPerMinute)}) {
+        bucket->rate = std::max(perMinute, 0.0) / 60.0;
+        // A bucket must hold at least one request, otherwise it would never be full
+        bucket->capacity = std::max(bucket->rate * burst, bucket == &m_requests ? 1.0 : 0.0);
+        bucket->tokens = bucket->capacity;
+    }
+}
+
+bool RateLimiter::isEnabled() const
+{
+    return m_requests.rate > 0.0 || m_units.rate > 0.0;
+}
+
+bool RateLimiter::acquire(double units, std::chrono::steady_clock::time_point deadline, const CancellationToken* cancellation)
+{
+    if (!isEnabled()) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t ticket = m_nextTicket++;
+    m_queue.push_back(ticket);
+
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (cancellation && cancellation->isCancelled()) {
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), ticket));
+            lock.unlock();
+            // The next caller may be the first in the queue now
+            m_cv.notify_all();
+            return false;
+        }
+        if (m_queue.front() == ticket) {
+            _refill(now);
+            double wait = _waitTime(units);
+            if (wait <= 0.0) {
+                break;
+            }
+            auto ready = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(wait));
+            if (ready > deadline) {
+                // The budget would arrive too late, do not keep the others waiting
+                m_queue.pop_front();
+                lock.unlock();
+                m_cv.notify_all();
+                return false;
+            }
+            m_cv.wait_until(lock, ready);
+        } else if (now >= deadline) {
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), ticket));
+            return false;
+        } else if (deadline == std::chrono::steady_clock::time_point::max()) {
+            m_cv.wait(lock);
+        } else {
+            m_cv.wait_until(lock, deadline);
+        }
+    }
+    double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    _consume(units);
+    m_queue.pop_front();
+    lock.unlock();
+    m_cv.notify_all();
+
+    if (waited > reportedWait) {
+        yCDebug(RATELIMITER) << "Request delayed by" << waited << "s to stay within the quota";
+    }
+    return true;
+}
+
+void RateLimiter::wakeUp()
+{
+    {
+        // Taken so that a caller about to wait does not miss the notification
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_cv.notify_all();
+}
+
+bool RateLimiter::tryAcquire(double units)
+{
+    if (!isEnabled()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_queue.empty()) {
+        return false;
+    }
+    _refill(std::chrono::steady_clock::now());
+    if (_waitTime(units) > 0.0) {
+        return false;
+    }
+    _consume(units);
+    return true;
+}
+
+void RateLimiter::_refill(std::chrono::steady_clock::time_point now)
+{
+    double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+    m_lastRefill = now;
+    for (Bucket* bucket : {&m_requests, &m_units}) {
+        bucket->tokens = std::min(bucket->capacity, bucket->tokens + bucket->rate * elapsed);
+    }
+}
+
+double RateLimiter::_waitTime(double units) const
+{
+    double wait = 0.0;
+    for (auto [bucket, needed] : {std::make_pair(&m_requests, 1.0), std::make_pair(&m_units, units)}) {
+        if (bucket->rate <= 0.0) {
+            continue;
+        }
+        double missing = std::min(needed, bucket->capacity) - bucket->tokens;
+        wait = std::max(wait, missing / bucket->rate);
+    }
+    return wait;
+}
+
+void RateLimiter::_consume(double units)
+{
+    // The bucket can go below zero after an oversized request, delaying the next ones
+    m_requests.tokens -= 1.0;
+    m_units.tokens -= units;
+}
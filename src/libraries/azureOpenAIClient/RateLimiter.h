@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_RATELIMITER_H
+#define AZUREOPENAI_RATELIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace azureopenai {
+
+class CancellationToken;
+
+/**
+ * \brief Client-side limiter matching the quotas of a deployment.
+ *
+ * Two token buckets limit the requests per minute and the units per minute,
+ * where the unit depends on the service (e.g. characters for the speech
+ * synthesis, seconds of audio for the transcription). Each bucket holds up
+ * to \p burst seconds of budget. The callers are served in order of arrival.
+ * A rate equal to 0 disables the corresponding bucket.
+ */
+class RateLimiter
+{
+public:
+    RateLimiter(double requestsPerMinute, double unitsPerMinute, double burst = 10.0);
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter(RateLimiter&&) noexcept = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+    RateLimiter& operator=(RateLimiter&&) noexcept = delete;
+    ~RateLimiter() = default;
+
+    bool isEnabled() const;
+
+    /**
+     * Block until there is budget for one request of \p units, and consume it.
+     * A request larger than the bucket is let through when the bucket is full.
+     * @return false if the budget is not available before \p deadline, or if
+     *         \p cancellation is cancelled while waiting (see wakeUp())
+     */
+    bool acquire(double units, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(), const CancellationToken* cancellation = nullptr);
+
+    /**
+     * Wake up the callers waiting in acquire(), so that they check their
+     * cancellation. It is subscribed to the CancellationToken of the call.
+     */
+    void wakeUp();
+
+    /**
+     * Consume the budget for one request of \p units only if it is available now.
+     */
+    bool tryAcquire(double units);
+
+private:
+    struct Bucket
+    {
+        double rate{0.0}; // per second
+        double capacity{0.0};
+        double tokens{0.0};
+    };
+
+    void _refill(std::chrono::steady_clock::time_point now);
+    // Seconds until the request can be served, 0 if it can be served now
+    double _waitTime(double units) const;
+    void _consume(double units);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    Bucket m_requests;
+    Bucket m_units;
+    std::chrono::steady_clock::time_point m_lastRefill;
+    std::deque<uint64_t> m_queue;
+    uint64_t m_nextTicket{0};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_RATELIMITER_H
@@ -0,0 +1,339 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "SharedHttpState.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(SHAREDHTTPSTATE, "yarp.azureOpenAIClient.SharedHttpState")
+
+std::mutex s_instanceMutex;
+SharedHttpState* s_instance{nullptr};
+size_t s_users{0};
+
+constexpr const char* cacheHeader = "# azureOpenAIClient HTTP cache v1";
+// The saved addresses are used for at most this long, in case the endpoint moves
+constexpr std::time_t addressMaxAge = 24 * 3600; // seconds
+
+std::string toHex(const unsigned char* data, size_t size)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(2 * size);
+    for (size_t i = 0; i < size; ++i) {
+        hex.push_back(digits[data[i] >> 4]);
+        hex.push_back(digits[data[i] & 0x0f]);
+    }
+    return hex;
+}
+
+bool fromHex(const std::string& hex, std::vector<unsigned char>& data)
+{
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    data.clear();
+    data.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        char* end = nullptr;
+        std::string byte = hex.substr(i, 2);
+        unsigned long value = std::strtoul(byte.c_str(), &end, 16);
+        if (*end != '\0') {
+            return false;
+        }
+        data.push_back(static_cast<unsigned char>(value));
+    }
+    return true;
+}
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+CURLcode exportSession(CURL* /*handle*/, void* userptr, const char* /*sessionKey*/,
+                       const unsigned char* shmac, size_t shmacLength,
+                       const unsigned char* sdata, size_t sdataLength,
+                       curl_off_t validUntil, int /*ietfTlsId*/, const char* /*alpn*/, size_t /*earlyDataMax*/)
+{
+    // Only the salted hash of the session key is saved, not the host names
+    if (shmac && shmacLength > 0 && sdata && sdataLength > 0) {
+        *static_cast<std::ostringstream*>(userptr) << "session " << static_cast<long long>(validUntil) << " "
+                                                   << toHex(shmac, shmacLength) << " " << toHex(sdata, sdataLength) << "\n";
+    }
+    return CURLE_OK;
+}
+#endif
+} // namespace
+
+SharedHttpState::SharedHttpState()
+{
+    // curl_global_init() is not thread safe, it is called once under s_instanceMutex
+    CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
+    if (res != CURLE_OK) {
+        yCError(SHAREDHTTPSTATE) << "curl_global_init failed:" << curl_easy_strerror(res);
+    }
+
+    m_share = curl_share_init();
+    if (!m_share) {
+        yCError(SHAREDHTTPSTATE) << "Failed to initialize the cURL share handle";
+        return;
+    }
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, _lock);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, _unlock);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // The connections are not shared: libcurl does not support a shared connection
+    // cache used by several threads at once, and would not multiplex the HTTP/2
+    // streams of different handles. They are pooled by the multi handle of the
+    // HttpEngine, which performs all the transfers of the process.
+    yCDebug(SHAREDHTTPSTATE) << "Shared HTTP state created";
+}
+
+SharedHttpState::~SharedHttpState()
+{
+    saveCache();
+    if (m_share) {
+        curl_share_cleanup(m_share);
+    }
+    curl_slist_free_all(m_resolve);
+    for (auto* resolve : m_retiredResolves) {
+        curl_slist_free_all(resolve);
+    }
+    curl_global_cleanup();
+    yCDebug(SHAREDHTTPSTATE) << "Shared HTTP state destroyed";
+}
+
+std::shared_ptr<SharedHttpState> SharedHttpState::acquire()
+{
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (!s_instance) {
+        s_instance = new SharedHttpState();
+    }
+    s_users++;
+
+    // Every user gets its own control block, the state is deleted by the last one
+    return std::shared_ptr<SharedHttpState>(s_instance, [](SharedHttpState*) {
+        std::lock_guard<std::mutex> lock(s_instanceMutex);
+        if (--s_users == 0) {
+            delete s_instance;
+            s_instance = nullptr;
+        }
+    });
+}
+
+void SharedHttpState::attach(CURL* curl) const
+{
+    if (curl && m_share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+    }
+    if (curl) {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, m_resolve);
+    }
+}
+
+void SharedHttpState::useCacheFile(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    if (!m_cacheFile.empty()) {
+        if (path != m_cacheFile) {
+            yCWarning(SHAREDHTTPSTATE) << "The process already uses the HTTP cache file" << m_cacheFile << ", ignoring" << path;
+        }
+        return;
+    }
+    m_cacheFile = path;
+    _loadCache(path);
+}
+
+void SharedHttpState::saveCache()
+{
+    std::ostringstream content;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (m_cacheFile.empty()) {
+            return;
+        }
+        path = m_cacheFile;
+        content << cacheHeader << "\n";
+        for (const auto& [hostPort, address] : m_addresses) {
+            content << "address " << hostPort << " " << address.ip << " " << static_cast<long long>(address.seen) << "\n";
+        }
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+    if (m_share) {
+        CURL* curl = curl_easy_init();
+        if (curl) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+            CURLcode res = curl_easy_ssls_export(curl, exportSession, &content);
+            if (res != CURLE_OK) {
+                yCDebug(SHAREDHTTPSTATE) << "The TLS sessions are not saved:" << curl_easy_strerror(res);
+            }
+            curl_easy_cleanup(curl);
+        }
+    }
+#endif
+
+    // The TLS sessions are secrets: the file is readable by the owner only, and
+    // replaced atomically so that a concurrent process never reads half of it
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            yCWarning(SHAREDHTTPSTATE) << "Unable to write the HTTP cache file" << temporary;
+            return;
+        }
+        std::error_code error;
+        std::filesystem::permissions(temporary, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write,
+                                     std::filesystem::perm_options::replace, error);
+        file << content.str();
+        if (!file) {
+            yCWarning(SHAREDHTTPSTATE) << "Unable to write the HTTP cache file" << temporary;
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        yCWarning(SHAREDHTTPSTATE) << "Unable to replace the HTTP cache file" << path << ":" << error.message();
+    }
+}
+
+void SharedHttpState::remember(CURL* curl)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        if (m_cacheFile.empty()) {
+            return;
+        }
+    }
+
+    char* ip = nullptr;
+    long port = 0;
+    char* url = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_PRIMARY_IP, &ip);
+    curl_easy_getinfo(curl, CURLINFO_PRIMARY_PORT, &port);
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+    // No address for the Unix domain sockets
+    if (ip == nullptr || *ip == '\0' || url == nullptr || port <= 0) {
+        return;
+    }
+
+    std::string host;
+    CURLU* parsed = curl_url();
+    char* parsedHost = nullptr;
+    if (parsed && curl_url_set(parsed, CURLUPART_URL, url, 0) == CURLUE_OK && curl_url_get(parsed, CURLUPART_HOST, &parsedHost, 0) == CURLUE_OK) {
+        host = parsedHost;
+    }
+    curl_free(parsedHost);
+    curl_url_cleanup(parsed);
+    if (host.empty() || host == ip || host.front() == '[') {
+        return;
+    }
+
+    std::string hostPort = host + ":" + std::to_string(port);
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_addresses[hostPort] = {ip, std::time(nullptr)};
+    // From now on the DNS cache of the process knows the host
+    if (m_pendingAddresses.erase(hostPort) > 0) {
+        _updateResolveList();
+    }
+}
+
+void SharedHttpState::_loadCache(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        yCDebug(SHAREDHTTPSTATE) << "No HTTP cache file" << path << "yet";
+        return;
+    }
+    std::string line;
+    if (!std::getline(file, line) || line != cacheHeader) {
+        yCWarning(SHAREDHTTPSTATE) << path << "is not an HTTP cache file, it will be overwritten";
+        return;
+    }
+
+    CURL* curl = nullptr;
+#if LIBCURL_VERSION_NUM >= 0x080c00
+    if (m_share) {
+        curl = curl_easy_init();
+        if (curl) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+        }
+    }
+#endif
+
+    std::time_t now = std::time(nullptr);
+    size_t sessions = 0;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "address") {
+            std::string hostPort;
+            Address address;
+            long long seen = 0;
+            if (fields >> hostPort >> address.ip >> seen && now - seen < addressMaxAge) {
+                address.seen = static_cast<std::time_t>(seen);
+                m_addresses[hostPort] = address;
+                m_pendingAddresses.insert(hostPort);
+            }
+        } else if (kind == "session") {
+            long long validUntil = 0;
+            std::string shmacHex;
+            std::string sdataHex;
+            std::vector<unsigned char> shmac;
+            std::vector<unsigned char> sdata;
+            if (!(fields >> validUntil >> shmacHex >> sdataHex) || (validUntil > 0 && validUntil <= now)
+                || !fromHex(shmacHex, shmac) || !fromHex(sdataHex, sdata) || curl == nullptr) {
+                continue;
+            }
+#if LIBCURL_VERSION_NUM >= 0x080c00
+            if (curl_easy_ssls_import(curl, nullptr, shmac.data(), shmac.size(), sdata.data(), sdata.size()) == CURLE_OK) {
+                ++sessions;
+            }
+#endif
+        }
+    }
+    if (curl) {
+        curl_easy_cleanup(curl);
+    }
+    _updateResolveList();
+    yCDebug(SHAREDHTTPSTATE) << "Loaded" << m_pendingAddresses.size() << "addresses and" << sessions << "TLS sessions from" << path;
+}
+
+void SharedHttpState::_updateResolveList()
+{
+    // The "+" prefix makes the entries expire as the resolved ones, so that the
+    // endpoints are looked up again after the usual DNS cache timeout
+    struct curl_slist* resolve = nullptr;
+    for (const auto& hostPort : m_pendingAddresses) {
+        const std::string& ip = m_addresses[hostPort].ip;
+        bool ipv6 = ip.find(':') != std::string::npos;
+        resolve = curl_slist_append(resolve, ("+" + hostPort + ":" + (ipv6 ? "[" + ip + "]" : ip)).c_str());
+    }
+    if (m_resolve) {
+        m_retiredResolves.push_back(m_resolve);
+    }
+    m_resolve = resolve;
+}
+
+void SharedHttpState::_lock(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void* userptr)
+{
+    static_cast<SharedHttpState*>(userptr)->m_locks[data].lock();
+}
+
+void SharedHttpState::_unlock(CURL* /*handle*/, curl_lock_data data, void* userptr)
+{
+    static_cast<SharedHttpState*>(userptr)->m_locks[data].unlock();
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_SHAREDHTTPSTATE_H
+#define AZUREOPENAI_SHAREDHTTPSTATE_H
+
+#include <curl/curl.h>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace azureopenai {
+
+/**
+ * \brief Process-wide HTTP state shared by all the azure openai devices.
+ *
+ * It owns the libcurl global initialization and a share handle holding the DNS
+ * cache and the TLS session cache, so that an easy handle attached to it skips
+ * the lookups and resumes the TLS sessions of the other handles of the process.
+ * The connections themselves are pooled by the HttpEngine.
+ *
+ * The state is created by the first call to acquire() and destroyed when the
+ * last returned pointer is released.
+ *
+ * Optionally (see useCacheFile()) the TLS sessions and the addresses of the
+ * endpoints outlive the process: they are saved to a file and loaded by the
+ * next run, whose first request skips the DNS lookup and resumes the TLS
+ * session instead of performing a full handshake. The TLS sessions require
+ * libcurl 8.12 or later, built with the session export support.
+ */
+class SharedHttpState
+{
+public:
+    SharedHttpState(const SharedHttpState&) = delete;
+    SharedHttpState(SharedHttpState&&) noexcept = delete;
+    SharedHttpState& operator=(const SharedHttpState&) = delete;
+    SharedHttpState& operator=(SharedHttpState&&) noexcept = delete;
+    ~SharedHttpState();
+
+    static std::shared_ptr<SharedHttpState> acquire();
+
+    /**
+     * Make an easy handle use the shared caches.
+     * The handle must be cleaned up before the state is released.
+     */
+    void attach(CURL* curl) const;
+
+    /**
+     * Load the TLS sessions and the addresses saved to \p path by a previous
+     * run, and save the current ones there when the state is destroyed.
+     * Only the first file set in the process is used.
+     */
+    void useCacheFile(const std::string& path);
+
+    /**
+     * Write the cache file, if any. Call it once the connections are up, so
+     * that the sessions survive a crash of the process.
+     */
+    void saveCache();
+
+    /**
+     * Remember the address a successful transfer connected to.
+     */
+    void remember(CURL* curl);
+
+private:
+    struct Address
+    {
+        std::string ip;
+        std::time_t seen{0};
+    };
+
+    SharedHttpState();
+
+    void _loadCache(const std::string& path);
+    void _updateResolveList();
+
+    static void _lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void _unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+    CURLSH* m_share{nullptr};
+    std::mutex m_locks[CURL_LOCK_DATA_LAST];
+
+    mutable std::mutex m_cacheMutex;
+    std::string m_cacheFile;
+    // host:port -> address
+    std::map<std::string, Address> m_addresses;
+    // Loaded addresses not yet used by a transfer of this process
+    std::set<std::string> m_pendingAddresses;
+    // CURLOPT_RESOLVE entries of the pending addresses. The replaced lists are
+    // kept until the destruction, as handles in flight may still refer to them
+    struct curl_slist* m_resolve{nullptr};
+    std::vector<struct curl_slist*> m_retiredResolves;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_SHAREDHTTPSTATE_H
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "StreamingBody.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace azureopenai;
+
+bool StreamingBody::claim(const void* writer, const std::string& contentType)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writer == writer) {
+        return true;
+    }
+    if (m_writer != nullptr || m_complete || m_closed) {
+        return false;
+    }
+    m_writer = writer;
+    m_contentType = contentType;
+    return true;
+}
+
+void StreamingBody::write(const void* writer, const char* data, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writer != writer || m_complete) {
+            return;
+        }
+        m_data.append(data, size);
+    }
+    m_cv.notify_all();
+}
+
+void StreamingBody::complete(const void* writer, bool ok)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writer != writer || m_complete) {
+            return;
+        }
+        if (ok) {
+            m_complete = true;
+        } else {
+            // The next attempt starts from scratch
+            m_writer = nullptr;
+            m_restarted = m_restarted || !m_data.empty() || m_readPosition > 0;
+            m_data.clear();
+            m_readPosition = 0;
+        }
+    }
+    m_cv.notify_all();
+}
+
+void StreamingBody::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_cv.notify_all();
+}
+
+size_t StreamingBody::read(char* data, size_t size)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t copied = 0;
+    while (copied < size) {
+        if (m_restarted) {
+            return 0;
+        }
+        size_t available = std::min(size - copied, m_data.size() - m_readPosition);
+        if (available > 0) {
+            std::memcpy(data + copied, m_data.data() + m_readPosition, available);
+            m_readPosition += available;
+            copied += available;
+        } else if (m_complete || m_closed) {
+            break;
+        } else {
+            m_cv.wait(lock);
+        }
+    }
+    return copied;
+}
+
+size_t StreamingBody::readSome(char* data, size_t size)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_restarted && m_readPosition == m_data.size() && !m_complete && !m_closed) {
+        m_cv.wait(lock);
+    }
+    if (m_restarted) {
+        return 0;
+    }
+    size_t available = std::min(size, m_data.size() - m_readPosition);
+    std::memcpy(data, m_data.data() + m_readPosition, available);
+    m_readPosition += available;
+    return available;
+}
+
+bool StreamingBody::restarted()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool restarted = m_restarted;
+    m_restarted = false;
+    return restarted;
+}
+
+bool StreamingBody::isComplete() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_complete;
+}
+
+size_t StreamingBody::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_data.size();
+}
+
+std::string StreamingBody::contentType() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_contentType;
+}
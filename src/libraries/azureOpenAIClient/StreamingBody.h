@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_STREAMINGBODY_H
+#define AZUREOPENAI_STREAMINGBODY_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace azureopenai {
+
+/**
+ * \brief Body of a successful response, consumed while it is downloaded.
+ *
+ * Set as HttpRequest::stream, it receives the body of the 2xx responses as
+ * the transport gets it, instead of HttpResponse::body, so that the caller can
+ * process it (e.g. decode the audio) on another thread while the download is
+ * still in progress.
+ *
+ * Only one transfer at a time writes the stream. If it fails (and the request
+ * is retried) the stream starts over: read() returns 0 and restarted() tells
+ * the reader to discard what it has read so far. A transfer that could not
+ * write the stream (e.g. a hedged duplicate) keeps its body and copies it to
+ * the stream if it completes successfully while the stream is free.
+ */
+class StreamingBody
+{
+public:
+    StreamingBody() = default;
+    StreamingBody(const StreamingBody&) = delete;
+    StreamingBody(StreamingBody&&) noexcept = delete;
+    StreamingBody& operator=(const StreamingBody&) = delete;
+    StreamingBody& operator=(StreamingBody&&) noexcept = delete;
+    ~StreamingBody() = default;
+
+    /**
+     * Called by the transport when \p writer receives the first byte of a 2xx response.
+     * @return true if \p writer is the one writing the stream
+     */
+    bool claim(const void* writer, const std::string& contentType = {});
+    void write(const void* writer, const char* data, size_t size);
+    // Called by the transport when \p writer completes
+    void complete(const void* writer, bool ok);
+
+    /**
+     * Called by the caller once the request is over: no more data will come,
+     * the readers waiting for data are woken up.
+     */
+    void close();
+
+    /**
+     * Copy up to \p size bytes to \p data, blocking until they are available.
+     * @return the bytes copied: less than \p size only at the end of the body,
+     *         0 also after a restart
+     */
+    size_t read(char* data, size_t size);
+
+    /**
+     * Like read(), but it returns as soon as some bytes are available, e.g.
+     * to relay the body while it is downloaded.
+     */
+    size_t readSome(char* data, size_t size);
+
+    /**
+     * True, once, if the stream started over since the last call.
+     */
+    bool restarted();
+
+    // True if the whole body of a successful response was written
+    bool isComplete() const;
+    // Bytes written so far
+    size_t size() const;
+    // The Content-Type of the response writing the stream
+    std::string contentType() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_data;
+    std::string m_contentType;
+    size_t m_readPosition{0};
+    const void* m_writer{nullptr};
+    bool m_complete{false};
+    bool m_closed{false};
+    bool m_restarted{false};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_STREAMINGBODY_H
@@ -0,0 +1,439 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "LocalHttpServer.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(LOCALHTTPSERVER, "yarp.azureOpenAIClient.LocalHttpServer")
+
+// How often the accept loop checks if it must stop
+constexpr int acceptPollPeriod = 100; // milliseconds
+
+// Limits of a request, the connection is closed if they are exceeded
+constexpr size_t maxHeaderSize = 64 * 1024;
+constexpr size_t maxBodySize = 64 * 1024 * 1024;
+
+std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string trim(const std::string& text)
+{
+    size_t begin = text.find_first_not_of(" \t");
+    size_t end = text.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+}
+
+bool readMore(int fd, std::string& buffer)
+{
+    char data[16384];
+    ssize_t size = ::recv(fd, data, sizeof(data), 0);
+    if (size <= 0) {
+        return false;
+    }
+    buffer.append(data, static_cast<size_t>(size));
+    return true;
+}
+} // namespace
+
+#if !defined(MSG_NOSIGNAL)
+// macOS, SO_NOSIGPIPE is set on the sockets instead
+#define MSG_NOSIGNAL 0
+#endif
+
+std::string LocalHttpRequest::header(const std::string& name) const
+{
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+}
+
+LocalHttpResponder::LocalHttpResponder(LocalHttpServer& server, int fd, const LocalHttpRequest& request) :
+        m_server(server),
+        m_fd(fd),
+        m_head(request.method == "HEAD"),
+        m_keepAlive(request.keepAlive)
+{
+}
+
+bool LocalHttpResponder::send(int status, const std::string& reason, const std::vector<std::string>& headers, const std::string& body)
+{
+    return sendHead(status, reason, headers, body.size()) && sendBody(body.data(), body.size());
+}
+
+bool LocalHttpResponder::sendHead(int status, const std::string& reason, const std::vector<std::string>& headers, size_t contentLength)
+{
+    std::string head = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n";
+    for (const auto& header : headers) {
+        head += header + "\r\n";
+    }
+    m_chunked = (contentLength == chunked);
+    if (m_chunked) {
+        head += "Transfer-Encoding: chunked\r\n";
+    } else {
+        head += "Content-Length: " + std::to_string(contentLength) + "\r\n";
+    }
+    if (!m_keepAlive) {
+        head += "Connection: close\r\n";
+    }
+    head += "\r\n";
+    m_sent = true;
+    return m_server._sendAll(m_fd, head.data(), head.size());
+}
+
+bool LocalHttpResponder::sendBody(const char* data, size_t size)
+{
+    // The body of the responses to HEAD requests is only announced
+    if (m_head || size == 0) {
+        return true;
+    }
+    if (!m_chunked) {
+        return m_server._sendAll(m_fd, data, size);
+    }
+    std::ostringstream chunkSize;
+    chunkSize << std::hex << size << "\r\n";
+    std::string prefix = chunkSize.str();
+    return m_server._sendAll(m_fd, prefix.data(), prefix.size()) && m_server._sendAll(m_fd, data, size) && m_server._sendAll(m_fd, "\r\n", 2);
+}
+
+bool LocalHttpResponder::endBody()
+{
+    if (m_head || !m_chunked) {
+        return true;
+    }
+    return m_server._sendAll(m_fd, "0\r\n\r\n", 5);
+}
+
+void LocalHttpResponder::abort()
+{
+    m_aborted = true;
+}
+
+bool LocalHttpResponder::sleep(double seconds)
+{
+    std::unique_lock<std::mutex> lock(m_server.m_mutex);
+    if (seconds <= 0.0) {
+        return !m_server.m_closing;
+    }
+    return !m_server.m_cv.wait_for(lock, std::chrono::duration<double>(seconds), [this] { return m_server.m_closing.load(); });
+}
+
+LocalHttpServer::LocalHttpServer(Handler handler) :
+        m_handler(std::move(handler))
+{
+}
+
+LocalHttpServer::~LocalHttpServer()
+{
+    close();
+}
+
+bool LocalHttpServer::listenTcp(const std::string& host, int port)
+{
+    if (m_listenFd >= 0) {
+        yCError(LOCALHTTPSERVER) << "The server is already listening";
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        yCError(LOCALHTTPSERVER) << "Invalid address" << host;
+        return false;
+    }
+
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        yCError(LOCALHTTPSERVER) << "Unable to create the socket";
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        yCError(LOCALHTTPSERVER) << "Unable to listen on" << host << ":" << port << ":" << std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    m_port = ntohs(address.sin_port);
+    return _start();
+}
+
+bool LocalHttpServer::listenUnix(const std::string& path, mode_t permissions)
+{
+    if (m_listenFd >= 0) {
+        yCError(LOCALHTTPSERVER) << "The server is already listening";
+        return false;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        yCError(LOCALHTTPSERVER) << "Invalid socket path" << path;
+        return false;
+    }
+    std::copy(path.begin(), path.end(), address.sun_path);
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        yCError(LOCALHTTPSERVER) << "Unable to create the socket";
+        return false;
+    }
+    // A socket file left by a crashed server would make bind() fail
+    ::unlink(path.c_str());
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        yCError(LOCALHTTPSERVER) << "Unable to listen on" << path << ":" << std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+    // The socket is created with the umask of the process, restrict it before listen() lets anyone connect
+    if (::chmod(path.c_str(), permissions) != 0) {
+        yCError(LOCALHTTPSERVER) << "Unable to set the permissions of" << path << ":" << std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        ::unlink(path.c_str());
+        return false;
+    }
+    m_unixPath = path;
+    m_port = 0;
+    return _start();
+}
+
+bool LocalHttpServer::_start()
+{
+    if (::listen(m_listenFd, SOMAXCONN) != 0) {
+        yCError(LOCALHTTPSERVER) << "listen() failed:" << std::strerror(errno);
+        close();
+        return false;
+    }
+    m_closing = false;
+    if (!start()) {
+        yCError(LOCALHTTPSERVER) << "Failed to start the server thread";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LocalHttpServer::close()
+{
+    if (m_listenFd < 0) {
+        return;
+    }
+
+    m_closing = true;
+    if (isRunning()) {
+        stop();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (int fd : m_connectionFds) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    m_cv.notify_all();
+    m_cv.wait(lock, [this] { return m_activeThreads == 0; });
+    lock.unlock();
+
+    ::close(m_listenFd);
+    m_listenFd = -1;
+    if (!m_unixPath.empty()) {
+        ::unlink(m_unixPath.c_str());
+        m_unixPath.clear();
+    }
+}
+
+int LocalHttpServer::port() const
+{
+    return m_port;
+}
+
+size_t LocalHttpServer::connections() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_connections;
+}
+
+void LocalHttpServer::run()
+{
+    pollfd listening{m_listenFd, POLLIN, 0};
+    while (!isStopping()) {
+        if (::poll(&listening, 1, acceptPollPeriod) <= 0) {
+            continue;
+        }
+        int fd = ::accept(m_listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        if (m_port != 0) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+#if defined(SO_NOSIGPIPE)
+        int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connectionFds.insert(fd);
+        ++m_activeThreads;
+        ++m_connections;
+        std::thread(&LocalHttpServer::_serve, this, fd).detach();
+    }
+}
+
+void LocalHttpServer::onStop()
+{
+    m_closing = true;
+}
+
+void LocalHttpServer::_serve(int fd)
+{
+    std::string buffer;
+    while (!m_closing) {
+        LocalHttpRequest request;
+        if (!_readRequest(fd, buffer, request)) {
+            break;
+        }
+        LocalHttpResponder responder(*this, fd, request);
+        m_handler(request, responder);
+        // A handler that did not answer leaves the connection in an unknown state
+        if (!responder.m_sent || responder.m_aborted || !request.keepAlive) {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connectionFds.erase(fd);
+    ::close(fd);
+    --m_activeThreads;
+    m_cv.notify_all();
+}
+
+bool LocalHttpServer::_readRequest(int fd, std::string& buffer, LocalHttpRequest& request)
+{
+    size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (buffer.size() > maxHeaderSize || !readMore(fd, buffer)) {
+            return false;
+        }
+    }
+
+    std::string head = buffer.substr(0, headerEnd);
+    buffer.erase(0, headerEnd + 4);
+
+    size_t lineEnd = head.find("\r\n");
+    std::string requestLine = head.substr(0, lineEnd);
+    size_t firstSpace = requestLine.find(' ');
+    size_t lastSpace = requestLine.rfind(' ');
+    if (firstSpace == std::string::npos || lastSpace == firstSpace) {
+        return false;
+    }
+    request.method = requestLine.substr(0, firstSpace);
+    std::string target = requestLine.substr(firstSpace + 1, lastSpace - firstSpace - 1);
+    std::string version = requestLine.substr(lastSpace + 1);
+    size_t question = target.find('?');
+    request.path = target.substr(0, question);
+    request.query = question == std::string::npos ? std::string() : target.substr(question + 1);
+
+    while (lineEnd != std::string::npos) {
+        size_t begin = lineEnd + 2;
+        lineEnd = head.find("\r\n", begin);
+        std::string line = head.substr(begin, lineEnd == std::string::npos ? std::string::npos : lineEnd - begin);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            request.headers[toLower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+        }
+    }
+
+    std::string connection = toLower(request.header("connection"));
+    request.keepAlive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+    if (toLower(request.header("expect")) == "100-continue") {
+        static const std::string continueLine = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (!_sendAll(fd, continueLine.data(), continueLine.size())) {
+            return false;
+        }
+    }
+
+    if (toLower(request.header("transfer-encoding")) == "chunked") {
+        while (true) {
+            size_t sizeEnd;
+            while ((sizeEnd = buffer.find("\r\n")) == std::string::npos) {
+                if (!readMore(fd, buffer)) {
+                    return false;
+                }
+            }
+            size_t chunkSize = std::strtoul(buffer.c_str(), nullptr, 16);
+            if (request.body.size() + chunkSize > maxBodySize) {
+                return false;
+            }
+            while (buffer.size() < sizeEnd + 2 + chunkSize + 2) {
+                if (!readMore(fd, buffer)) {
+                    return false;
+                }
+            }
+            request.body.append(buffer, sizeEnd + 2, chunkSize);
+            buffer.erase(0, sizeEnd + 2 + chunkSize + 2);
+            if (chunkSize == 0) {
+                // Trailers are not supported
+                return true;
+            }
+        }
+    }
+
+    size_t contentLength = std::strtoul(request.header("content-length").c_str(), nullptr, 10);
+    if (contentLength > maxBodySize) {
+        return false;
+    }
+    while (buffer.size() < contentLength) {
+        if (!readMore(fd, buffer)) {
+            return false;
+        }
+    }
+    request.body = buffer.substr(0, contentLength);
+    buffer.erase(0, contentLength);
+    return true;
+}
+
+bool LocalHttpServer::_sendAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_LOCALHTTPSERVER_H
+#define AZUREOPENAI_LOCALHTTPSERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+
+#include <sys/types.h>
+
+namespace azureopenai {
+
+class LocalHttpServer;
+
+/**
+ * \brief A request received by a LocalHttpServer.
+ */
+struct LocalHttpRequest
+{
+    std::string method;
+    // The path of the request target, without the query
+    std::string path;
+    std::string query;
+    // Header names are lowercase
+    std::map<std::string, std::string> headers;
+    std::string body;
+    bool keepAlive{true};
+
+    // The value of a header, empty if missing. \p name must be lowercase.
+    std::string header(const std::string& name) const;
+};
+
+/**
+ * \brief Writes the response to a LocalHttpRequest.
+ *
+ * Either send() is called once, or sendHead() followed by sendBody() until
+ * the announced length is written. If the length is not known in advance,
+ * sendHead() with \ref chunked sends the body with the chunked transfer
+ * encoding, and endBody() terminates it. All the methods return false if the
+ * connection was closed, in which case the handler should return.
+ */
+class LocalHttpResponder
+{
+public:
+    static constexpr size_t chunked = static_cast<size_t>(-1);
+
+    bool send(int status, const std::string& reason, const std::vector<std::string>& headers, const std::string& body);
+    bool sendHead(int status, const std::string& reason, const std::vector<std::string>& headers, size_t contentLength);
+    bool sendBody(const char* data, size_t size);
+    bool endBody();
+
+    /**
+     * Close the connection after the handler returns, e.g. to let the client
+     * know that a body already started will not be completed.
+     */
+    void abort();
+
+    /**
+     * Wait, returning early (and false) if the server is closed.
+     */
+    bool sleep(double seconds);
+
+private:
+    friend class LocalHttpServer;
+    LocalHttpResponder(LocalHttpServer& server, int fd, const LocalHttpRequest& request);
+
+    LocalHttpServer& m_server;
+    int m_fd;
+    bool m_head;
+    bool m_keepAlive;
+    bool m_sent{false};
+    bool m_chunked{false};
+    bool m_aborted{false};
+};
+
+/**
+ * \brief Minimal HTTP/1.1 server, listening on a TCP port or on a Unix domain socket.
+ *
+ * Each connection is served by its own thread, which reads the requests
+ * (Content-Length or chunked bodies, Expect: 100-continue) and passes them to
+ * the handler. Connections are kept alive. It is used by the local gateway and
+ * by the mock of the Azure OpenAI APIs, it is not meant to face a network.
+ */
+class LocalHttpServer :
+        private yarp::os::Thread
+{
+public:
+    using Handler = std::function<void(const LocalHttpRequest&, LocalHttpResponder&)>;
+
+    explicit LocalHttpServer(Handler handler);
+    LocalHttpServer(const LocalHttpServer&) = delete;
+    LocalHttpServer(LocalHttpServer&&) noexcept = delete;
+    LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+    LocalHttpServer& operator=(LocalHttpServer&&) noexcept = delete;
+    ~LocalHttpServer() override;
+
+    /**
+     * Listen on \p host : \p port, port 0 picks a free one.
+     */
+    bool listenTcp(const std::string& host, int port);
+
+    /**
+     * Listen on the Unix domain socket \p path, replacing a stale socket file.
+     * Only the processes allowed by \p permissions (the mode of the socket
+     * file, e.g. 0660 for the owner and its group) can connect.
+     */
+    bool listenUnix(const std::string& path, mode_t permissions = 0600);
+
+    /**
+     * Stop serving and wait for all the connections to be closed.
+     */
+    void close();
+
+    /**
+     * The TCP port the server listens on, 0 for a Unix domain socket.
+     */
+    int port() const;
+
+    /**
+     * The number of connections accepted so far.
+     */
+    size_t connections() const;
+
+private:
+    friend class LocalHttpResponder;
+
+    // yarp::os::Thread
+    void run() override;
+    void onStop() override;
+
+    bool _start();
+    void _serve(int fd);
+    bool _readRequest(int fd, std::string& buffer, LocalHttpRequest& request);
+    bool _sendAll(int fd, const char* data, size_t size);
+
+    Handler m_handler;
+    int m_listenFd{-1};
+    int m_port{0};
+    std::string m_unixPath;
+    size_t m_connections{0};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_closing{false};
+    std::set<int> m_connectionFds;
+    size_t m_activeThreads{0};
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_LOCALHTTPSERVER_H
@@ -0,0 +1,300 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "AzureOpenAIGateway.h"
+
+#include <CancellationToken.h>
+#include <HttpEngine.h>
+#include <RateLimiter.h>
+#include <StreamingBody.h>
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <future>
+#include <set>
+#include <vector>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(AZUREOPENAIGATEWAY, "yarp.azureOpenAIClient.AzureOpenAIGateway")
+
+// Headers of the local connection, not forwarded to Azure
+const std::set<std::string> hopByHopHeaders = {
+    "host",
+    "connection",
+    "keep-alive",
+    "content-length",
+    "transfer-encoding",
+    "expect",
+    "x-forwarded-proto",
+};
+
+// Largest piece of a streamed body relayed at once [bytes]
+constexpr size_t relayBufferSize = 16384;
+
+// Domains of the Azure OpenAI resources, allowed if no host is configured
+const std::vector<std::string> azureDomains = {
+    ".openai.azure.com",
+    ".cognitiveservices.azure.com",
+};
+
+std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() > suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+} // namespace
+
+AzureOpenAIGateway::AzureOpenAIGateway() :
+        m_server([this](const LocalHttpRequest& request, LocalHttpResponder& responder) { _handle(request, responder); })
+{
+}
+
+AzureOpenAIGateway::~AzureOpenAIGateway()
+{
+    close();
+}
+
+bool AzureOpenAIGateway::open(const GatewayOptions& options)
+{
+    close();
+    m_options = options;
+    if (!HttpEngine::httpVersionFromString(m_options.httpVersion, m_httpVersion)) {
+        yCError(AZUREOPENAIGATEWAY) << "Invalid HTTP version" << m_options.httpVersion << "(valid values are 1.1, 2 and 3)";
+        return false;
+    }
+
+    m_httpState = SharedHttpState::acquire();
+    if (!m_options.cacheFile.empty()) {
+        m_httpState->useCacheFile(m_options.cacheFile);
+    }
+    m_transport = HttpEngine::acquire();
+    m_client = std::make_unique<HttpClient>(m_transport);
+    // The devices retry on their own, retrying here too would multiply the attempts
+    RetryOptions retry;
+    retry.maxRetries = 0;
+    m_client->setRetry(retry);
+    m_client->setRateLimiter(std::make_shared<RateLimiter>(m_options.requestsPerMinute, 0.0, m_options.burst));
+
+    for (auto& host : m_options.allowedHosts) {
+        host = toLower(host);
+    }
+    if (!m_server.listenUnix(m_options.socketPath, m_options.groupAccess ? 0660 : 0600)) {
+        close();
+        return false;
+    }
+    yCInfo(AZUREOPENAIGATEWAY) << "Listening on" << m_options.socketPath;
+    return true;
+}
+
+void AzureOpenAIGateway::close()
+{
+    // Wait for the handlers first, they use the client and the warmers
+    m_server.close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_warmers.clear();
+    m_client.reset();
+    m_transport.reset();
+    m_httpState.reset();
+}
+
+GatewayStats AzureOpenAIGateway::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void AzureOpenAIGateway::_handle(const LocalHttpRequest& request, LocalHttpResponder& responder)
+{
+    std::string host = request.header("host");
+    if (host.empty()) {
+        responder.send(400, _reason(400), {"Content-Type: application/json"}, R"({"error": {"code": "400", "message": "Missing Host header"}})");
+        return;
+    }
+    if (!_isAllowed(host)) {
+        yCWarning(AZUREOPENAIGATEWAY) << "Refusing to forward a request to" << host;
+        responder.send(403, _reason(403), {"Content-Type: application/json"}, R"({"error": {"code": "403", "message": "The gateway does not forward requests to this host"}})");
+        return;
+    }
+    std::string scheme = request.header("x-forwarded-proto");
+    if (scheme.empty()) {
+        scheme = m_options.defaultScheme;
+    }
+    std::string url = scheme + "://" + host + request.path + (request.query.empty() ? "" : "?" + request.query);
+
+    if (request.method == "HEAD") {
+        _warmUp(url, request, responder);
+    } else if (request.method == "POST") {
+        _forward(url, request, responder);
+    } else {
+        responder.send(405, _reason(405), {"Content-Type: application/json"}, R"({"error": {"code": "405", "message": "Only POST requests are forwarded"}})");
+    }
+}
+
+void AzureOpenAIGateway::_forward(const std::string& url, const LocalHttpRequest& request, LocalHttpResponder& responder)
+{
+    struct curl_slist* headers = nullptr;
+    for (const auto& [name, value] : request.headers) {
+        if (hopByHopHeaders.count(name) == 0) {
+            headers = curl_slist_append(headers, (name + ": " + value).c_str());
+        }
+    }
+
+    HttpRequest upstream;
+    upstream.url = url;
+    upstream.headers = headers;
+    upstream.body = request.body;
+    upstream.httpVersion = m_httpVersion;
+    upstream.timeouts = m_options.timeouts;
+    // The successful bodies (e.g. the audio) are relayed while they are downloaded
+    auto stream = std::make_shared<StreamingBody>();
+    upstream.stream = stream;
+    auto cancellation = std::make_shared<CancellationToken>();
+    upstream.cancellation = cancellation;
+    std::future<HttpResponse> performing = std::async(std::launch::async, [this, &upstream, &stream]() {
+        HttpResponse response = m_client->perform(std::move(upstream));
+        stream->close();
+        return response;
+    });
+
+    // The length is not known until the download completes, the body is sent in chunks
+    bool streaming = false;
+    bool connected = true;
+    std::vector<char> buffer(relayBufferSize);
+    size_t size = 0;
+    while (connected && (size = stream->readSome(buffer.data(), buffer.size())) > 0) {
+        if (!streaming) {
+            std::vector<std::string> headersBack;
+            std::string contentType = stream->contentType();
+            if (!contentType.empty()) {
+                headersBack.push_back("Content-Type: " + contentType);
+            }
+            connected = responder.sendHead(200, _reason(200), headersBack, LocalHttpResponder::chunked);
+            streaming = true;
+        }
+        connected = connected && responder.sendBody(buffer.data(), size);
+    }
+    if (!connected) {
+        // The device went away, there is no point in completing the download
+        cancellation->cancel();
+    }
+    HttpResponse response = performing.get();
+    curl_slist_free_all(headers);
+
+    std::string scheme = url.substr(0, url.find("://"));
+    std::string origin = scheme + "://" + request.header("host");
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.requests;
+        auto warmer = m_warmers.find(origin);
+        if (warmer != m_warmers.end()) {
+            warmer->second->notifyActivity();
+        }
+        if (!response.ok()) {
+            ++m_stats.failures;
+        }
+    }
+
+    if (streaming) {
+        if (!stream->isComplete() || stream->restarted()) {
+            // Closing the connection before the end of the chunked body tells the device that the transfer failed
+            yCWarning(AZUREOPENAIGATEWAY) << "Request to" << url << "failed while relaying the body:" << curl_easy_strerror(response.result);
+            responder.abort();
+        } else if (!responder.endBody()) {
+            responder.abort();
+        }
+        return;
+    }
+
+    if (response.result != CURLE_OK) {
+        long status = response.deadlineExceeded || response.result == CURLE_OPERATION_TIMEDOUT ? 504 : 502;
+        yCWarning(AZUREOPENAIGATEWAY) << "Request to" << url << "failed:" << curl_easy_strerror(response.result);
+        responder.send(status, _reason(status), {"Content-Type: application/json"},
+                       R"({"error": {"code": ")" + std::to_string(status) + R"(", "message": ")" + curl_easy_strerror(response.result) + R"("}})");
+        return;
+    }
+
+    std::vector<std::string> headersBack;
+    if (!response.contentType.empty()) {
+        headersBack.push_back("Content-Type: " + response.contentType);
+    }
+    if (response.retryAfter >= 0.0) {
+        headersBack.push_back("retry-after-ms: " + std::to_string(static_cast<long>(std::ceil(response.retryAfter * 1000.0))));
+    }
+    // The errors and the empty bodies, which were not streamed
+    responder.send(static_cast<int>(response.status), _reason(response.status), headersBack, response.body);
+}
+
+void AzureOpenAIGateway::_warmUp(const std::string& url, const LocalHttpRequest& request, LocalHttpResponder& responder)
+{
+    std::string scheme = url.substr(0, url.find("://"));
+    std::string origin = scheme + "://" + request.header("host");
+    ConnectionWarmer* warmer = _warmer(origin, url);
+    bool reachable = warmer->warmUp();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.warmUps;
+    }
+    if (reachable) {
+        m_httpState->saveCache();
+    }
+    long status = reachable ? 200 : 502;
+    responder.send(static_cast<int>(status), _reason(status), {}, {});
+}
+
+ConnectionWarmer* AzureOpenAIGateway::_warmer(const std::string& origin, const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& warmer = m_warmers[origin];
+    if (!warmer) {
+        // No API key: the warmer outlives the device that created it, and any answer keeps the connection warm
+        warmer = std::make_unique<ConnectionWarmer>(m_transport, url, std::string{}, std::string{}, std::vector<std::string>{}, m_httpVersion);
+        warmer->startKeepAlive(m_options.keepAlivePeriod);
+    }
+    return warmer.get();
+}
+
+bool AzureOpenAIGateway::_isAllowed(const std::string& host) const
+{
+    std::string name = toLower(host);
+    if (!m_options.allowedHosts.empty()) {
+        return std::find(m_options.allowedHosts.begin(), m_options.allowedHosts.end(), name) != m_options.allowedHosts.end();
+    }
+    // A plain domain name, on the default port of the scheme: the host becomes part of the url
+    bool plain = std::all_of(name.begin(), name.end(), [](unsigned char c) { return std::isalnum(c) || c == '.' || c == '-'; });
+    if (!plain) {
+        return false;
+    }
+    return std::any_of(azureDomains.begin(), azureDomains.end(), [&name](const std::string& domain) { return endsWith(name, domain); });
+}
+
+std::string AzureOpenAIGateway::_reason(long status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Status " + std::to_string(status);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_AZUREOPENAIGATEWAY_H
+#define AZUREOPENAI_AZUREOPENAIGATEWAY_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ConnectionWarmer.h>
+#include <HttpClient.h>
+#include <HttpRequest.h>
+#include <LocalHttpServer.h>
+#include <SharedHttpState.h>
+
+namespace azureopenai {
+
+/**
+ * \brief Options of the AzureOpenAIGateway.
+ */
+struct GatewayOptions
+{
+    // Unix domain socket the devices connect to
+    std::string socketPath{"/tmp/azureopenai-gateway.sock"};
+    // If true the users of the group of the gateway can connect too, otherwise only its owner
+    bool groupAccess{false};
+    // Hosts (host or host:port) the requests can be forwarded to; if empty, the Azure OpenAI resources
+    std::vector<std::string> allowedHosts;
+    // HTTP version used towards Azure, "1.1", "2" or "3"
+    std::string httpVersion{"2"};
+    HttpTimeouts timeouts{5.0, 20.0, 1000, 10.0, 60.0};
+    // Requests per minute forwarded to Azure by the whole fleet, 0 for no limit
+    double requestsPerMinute{0.0};
+    double burst{10.0};
+    // Idle time after which a keep-alive request is sent to each Azure endpoint, 0 to disable [s]
+    double keepAlivePeriod{0.0};
+    // Scheme used towards Azure when the request does not carry X-Forwarded-Proto
+    std::string defaultScheme{"https"};
+    // If not empty, file storing the TLS sessions and the addresses across restarts
+    std::string cacheFile;
+};
+
+/**
+ * \brief Counters of the requests forwarded by the AzureOpenAIGateway.
+ */
+struct GatewayStats
+{
+    size_t requests{0};
+    size_t warmUps{0};
+    size_t failures{0};
+};
+
+/**
+ * \brief Local gateway forwarding the requests of many devices to Azure OpenAI.
+ *
+ * The devices (see the HTTP::gateway_socket parameter) send plain HTTP/1.1
+ * requests to a Unix domain socket; the gateway forwards them through a single
+ * HttpEngine, so that all the processes of a machine share the same warm TLS
+ * connections (multiplexed with HTTP/2), DNS and TLS session caches, and a
+ * single rate limit. The HEAD requests of the devices' warm-ups open and keep
+ * alive the connections to the corresponding Azure endpoint, without the API
+ * keys: the gateway holds no credentials, each request carries its own.
+ * The successful bodies are relayed with the chunked transfer encoding while
+ * they are downloaded, so that the devices can decode the audio as it comes.
+ *
+ * The gateway does not retry: the failures, including the Retry-After hints,
+ * are passed back to the devices, which apply their own policies.
+ */
+class AzureOpenAIGateway
+{
+public:
+    AzureOpenAIGateway();
+    AzureOpenAIGateway(const AzureOpenAIGateway&) = delete;
+    AzureOpenAIGateway(AzureOpenAIGateway&&) noexcept = delete;
+    AzureOpenAIGateway& operator=(const AzureOpenAIGateway&) = delete;
+    AzureOpenAIGateway& operator=(AzureOpenAIGateway&&) noexcept = delete;
+    ~AzureOpenAIGateway();
+
+    bool open(const GatewayOptions& options);
+    void close();
+
+    GatewayStats stats() const;
+
+private:
+    void _handle(const LocalHttpRequest& request, LocalHttpResponder& responder);
+    void _forward(const std::string& url, const LocalHttpRequest& request, LocalHttpResponder& responder);
+    void _warmUp(const std::string& url, const LocalHttpRequest& request, LocalHttpResponder& responder);
+    ConnectionWarmer* _warmer(const std::string& origin, const std::string& url);
+    bool _isAllowed(const std::string& host) const;
+
+    static std::string _reason(long status);
+
+    GatewayOptions m_options;
+    long m_httpVersion{CURL_HTTP_VERSION_2TLS};
+    std::shared_ptr<SharedHttpState> m_httpState;
+    // The HttpEngine, shared by the forwarded requests and the warm-ups
+    std::shared_ptr<IHttpTransport> m_transport;
+    std::unique_ptr<HttpClient> m_client;
+
+    mutable std::mutex m_mutex;
+    // One warmer per Azure endpoint (scheme://host)
+    std::map<std::string, std::unique_ptr<ConnectionWarmer>> m_warmers;
+    GatewayStats m_stats;
+
+    LocalHttpServer m_server;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_AZUREOPENAIGATEWAY_H
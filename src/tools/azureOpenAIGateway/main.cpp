@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "AzureOpenAIGateway.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include <csignal>
+#include <iostream>
+
+namespace {
+volatile std::sig_atomic_t interrupted = 0;
+
+void onSignal(int)
+{
+    interrupted = 1;
+}
+
+void printHelp()
+{
+    azureopenai::GatewayOptions defaults;
+    std::cout << "Usage: azureOpenAIGateway [options]\n"
+                 "  --socket <path>                Unix domain socket the devices connect to (default " << defaults.socketPath << ")\n"
+                 "  --group_access                 let the users of the group of the gateway connect, not only its owner\n"
+                 "  --allowed_hosts \"(<host> ...)\" hosts the requests can be forwarded to (default: *.openai.azure.com and *.cognitiveservices.azure.com)\n"
+                 "  --http_version <1.1|2|3>       HTTP version used towards Azure (default 2)\n"
+                 "  --requests_per_minute <n>      requests per minute forwarded to Azure, 0 for no limit (default 0)\n"
+                 "  --burst <s>                    seconds of budget that can be spent at once (default 10)\n"
+                 "  --keepalive_period <s>         idle time after which the Azure connections are pinged, 0 to disable (default 0)\n"
+                 "  --cache_file <path>            file storing the TLS sessions and the addresses across restarts\n"
+                 "  --connect_timeout <s>          (default 5)\n"
+                 "  --first_byte_timeout <s>       (default 20)\n"
+                 "  --total_timeout <s>            (default 60)\n"
+                 "\n"
+                 "Set HTTP::gateway_socket of the ttsDevice and whisperDevice to the same socket.\n";
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    yarp::os::Property config;
+    config.fromCommand(argc, argv);
+    if (config.check("help")) {
+        printHelp();
+        return 0;
+    }
+
+    azureopenai::GatewayOptions options;
+    options.socketPath = config.check("socket", yarp::os::Value(options.socketPath)).asString();
+    options.groupAccess = config.check("group_access");
+    if (yarp::os::Bottle* hosts = config.find("allowed_hosts").asList()) {
+        for (size_t i = 0; i < hosts->size(); ++i) {
+            options.allowedHosts.push_back(hosts->get(i).asString());
+        }
+    }
+    options.httpVersion = config.check("http_version", yarp::os::Value(options.httpVersion)).asString();
+    options.requestsPerMinute = config.check("requests_per_minute", yarp::os::Value(options.requestsPerMinute)).asFloat64();
+    options.burst = config.check("burst", yarp::os::Value(options.burst)).asFloat64();
+    options.keepAlivePeriod = config.check("keepalive_period", yarp::os::Value(options.keepAlivePeriod)).asFloat64();
+    options.cacheFile = config.check("cache_file", yarp::os::Value(options.cacheFile)).asString();
+    options.timeouts.connect = config.check("connect_timeout", yarp::os::Value(options.timeouts.connect)).asFloat64();
+    options.timeouts.firstByte = config.check("first_byte_timeout", yarp::os::Value(options.timeouts.firstByte)).asFloat64();
+    options.timeouts.total = config.check("total_timeout", yarp::os::Value(options.timeouts.total)).asFloat64();
+
+    azureopenai::AzureOpenAIGateway gateway;
+    if (!gateway.open(options)) {
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    while (interrupted == 0) {
+        yarp::os::Time::delay(0.1);
+    }
+    gateway.close();
+
+    azureopenai::GatewayStats stats = gateway.stats();
+    std::cout << "requests: " << stats.requests
+              << ", failed: " << stats.failures
+              << ", warm-ups: " << stats.warmUps << std::endl;
+    return 0;
+}
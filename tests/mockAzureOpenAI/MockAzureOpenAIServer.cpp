@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "MockAzureOpenAIServer.h"
+
+#include <FakeHttpTransport.h>
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+
+using namespace azureopenai;
+
+namespace {
+YARP_LOG_COMPONENT(MOCKAZUREOPENAISERVER, "yarp.azureOpenAIClient.MockAzureOpenAIServer")
+
+// Granularity of the bandwidth emulation
+constexpr double chunkPeriod = 0.01; // seconds
+
+bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+} // namespace
+
+MockAzureOpenAIServer::MockAzureOpenAIServer(const MockServerOptions& options) :
+        m_server([this](const LocalHttpRequest& request, LocalHttpResponder& responder) { _handle(request, responder); })
+{
+    setOptions(options);
+    m_options.host = options.host;
+    m_options.port = options.port;
+}
+
+MockAzureOpenAIServer::~MockAzureOpenAIServer()
+{
+    close();
+}
+
+bool MockAzureOpenAIServer::open()
+{
+    if (!m_server.listenTcp(m_options.host, m_options.port)) {
+        return false;
+    }
+    yCInfo(MOCKAZUREOPENAISERVER) << "Listening on" << endpoint();
+    return true;
+}
+
+void MockAzureOpenAIServer::close()
+{
+    m_server.close();
+}
+
+int MockAzureOpenAIServer::port() const
+{
+    return m_server.port();
+}
+
+std::string MockAzureOpenAIServer::endpoint() const
+{
+    return "http://" + m_options.host + ":" + std::to_string(m_server.port());
+}
+
+void MockAzureOpenAIServer::setOptions(const MockServerOptions& options)
+{
+    std::string speech = options.speech.empty() ? FakeHttpTransport::silentMp3(options.speechDuration) : options.speech;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string host = m_options.host;
+    int port = m_options.port;
+    m_options = options;
+    m_options.host = host;
+    m_options.port = port;
+    m_speech = std::move(speech);
+}
+
+void MockAzureOpenAIServer::throttleNext(int count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_throttleNext = std::max(count, 0);
+}
+
+MockServerStats MockAzureOpenAIServer::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MockServerStats stats = m_stats;
+    stats.connections = m_server.connections();
+    return stats;
+}
+
+void MockAzureOpenAIServer::_handle(const LocalHttpRequest& request, LocalHttpResponder& responder)
+{
+    Response response = _respond(request);
+    double latency;
+    double bandwidth;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latency = m_options.latency;
+        bandwidth = m_options.bandwidth;
+    }
+
+    if (response.delayed && !responder.sleep(latency)) {
+        return;
+    }
+    response.headers.push_back("apim-request-id: mock");
+    if (bandwidth <= 0.0) {
+        responder.send(response.status, response.reason, response.headers, response.body);
+        return;
+    }
+    if (!responder.sendHead(response.status, response.reason, response.headers, response.body.size())) {
+        return;
+    }
+    auto chunk = static_cast<size_t>(std::max(1.0, bandwidth * chunkPeriod));
+    for (size_t sent = 0; sent < response.body.size(); sent += chunk) {
+        size_t size = std::min(chunk, response.body.size() - sent);
+        if (!responder.sendBody(response.body.data() + sent, size) || (sent + size < response.body.size() && !responder.sleep(chunkPeriod))) {
+            return;
+        }
+    }
+}
+
+MockAzureOpenAIServer::Response MockAzureOpenAIServer::_respond(const LocalHttpRequest& request)
+{
+    bool speech = endsWith(request.path, "/audio/speech");
+    bool transcription = endsWith(request.path, "/audio/transcriptions");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (request.method == "HEAD") {
+        // Connection warm-ups
+        Response response = _error(404, "Not Found", "404", "Resource not found");
+        response.delayed = false;
+        return response;
+    }
+    if (request.method != "POST" || (!speech && !transcription)) {
+        return _error(404, "Not Found", "404", "Resource not found");
+    }
+    if (!m_options.apiKey.empty() && request.header("api-key") != m_options.apiKey) {
+        ++m_stats.rejected;
+        return _error(401, "Unauthorized", "401", "Access denied due to invalid subscription key or wrong API endpoint.");
+    }
+
+    size_t index = ++m_apiRequests;
+    bool throttle = false;
+    if (m_throttleNext > 0) {
+        --m_throttleNext;
+        throttle = true;
+    } else if (index <= static_cast<size_t>(std::max(m_options.throttleFirst, 0))) {
+        throttle = true;
+    } else if (m_options.throttleEvery > 0 && index % static_cast<size_t>(m_options.throttleEvery) == 0) {
+        throttle = true;
+    }
+    if (throttle) {
+        ++m_stats.throttled;
+        Response response = _error(429, "Too Many Requests", "429", "Requests to the API have exceeded the rate limit. Please retry later.");
+        response.headers.push_back("retry-after-ms: " + std::to_string(m_options.retryAfterMs));
+        response.headers.push_back("Retry-After: " + std::to_string((m_options.retryAfterMs + 999) / 1000));
+        return response;
+    }
+
+    Response response;
+    if (speech) {
+        if (request.body.find("\"input\"") == std::string::npos) {
+            ++m_stats.rejected;
+            return _error(400, "Bad Request", "invalid_request_error", "'input' is a required property");
+        }
+        std::string format = FakeHttpTransport::speechFormat(request.body);
+        if (format != "mp3" && format != "pcm" && format != "wav") {
+            ++m_stats.rejected;
+            return _error(400, "Bad Request", "invalid_request_error", "The mock has no speech in the " + format + " format");
+        }
+        ++m_stats.speech;
+        if (format == "mp3") {
+            response.headers = {"Content-Type: audio/mpeg"};
+            response.body = m_speech;
+        } else {
+            response.headers = {format == "wav" ? "Content-Type: audio/wav" : "Content-Type: audio/pcm"};
+            response.body = FakeHttpTransport::silentPcm(m_options.speechDuration, format == "wav");
+        }
+    } else {
+        if (request.body.find("name=\"file\"") == std::string::npos) {
+            ++m_stats.rejected;
+            return _error(400, "Bad Request", "invalid_request_error", "'file' is a required property");
+        }
+        ++m_stats.transcriptions;
+        if (request.body.find("verbose_json") != std::string::npos) {
+            response.body = FakeHttpTransport::verboseJsonTranscription(m_options.transcription, m_options.transcriptionDuration);
+        } else {
+            response.body = R"({"text": ")" + m_options.transcription + R"("})";
+        }
+    }
+    return response;
+}
+
+MockAzureOpenAIServer::Response MockAzureOpenAIServer::_error(int status, const std::string& reason, const std::string& code, const std::string& message)
+{
+    Response response;
+    response.status = status;
+    response.reason = reason;
+    response.body = R"({"error": {"code": ")" + code + R"(", "message": ")" + message + R"("}})";
+    return response;
+}
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef AZUREOPENAI_MOCKAZUREOPENAISERVER_H
+#define AZUREOPENAI_MOCKAZUREOPENAISERVER_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <LocalHttpServer.h>
+
+namespace azureopenai {
+
+/**
+ * \brief Behaviour of the MockAzureOpenAIServer.
+ */
+struct MockServerOptions
+{
+    // Address and port to listen on, port 0 picks a free one
+    std::string host{"127.0.0.1"};
+    int port{0};
+    // Time between the end of a request and the response headers [s]
+    double latency{0.0};
+    // Upload speed of the response bodies, 0 for unlimited [bytes/s]
+    double bandwidth{0.0};
+    // If not empty, the MP3 served by /audio/speech, instead of a silent one
+    std::string speech;
+    // Duration of the silent speech [s]
+    double speechDuration{3.0};
+    // Text and duration of the transcriptions
+    std::string transcription{"Hello world"};
+    double transcriptionDuration{1.0};
+    // The first throttleFirst requests are answered with a 429
+    int throttleFirst{0};
+    // If not 0, one request out of throttleEvery is answered with a 429
+    int throttleEvery{0};
+    // Value of the retry-after-ms header of the 429 responses
+    int retryAfterMs{100};
+    // If not empty, the requests without this api-key are answered with a 401
+    std::string apiKey;
+};
+
+/**
+ * \brief Counters of the requests served by the MockAzureOpenAIServer.
+ */
+struct MockServerStats
+{
+    size_t connections{0};
+    size_t speech{0};
+    size_t transcriptions{0};
+    size_t throttled{0};
+    size_t rejected{0};
+};
+
+/**
+ * \brief Local HTTP/1.1 server emulating the audio APIs of Azure OpenAI.
+ *
+ * POST .../audio/speech returns an MP3 (or pcm and wav, if the request asks
+ * for that response_format, a 400 for the other formats), POST
+ * .../audio/transcriptions a
+ * transcription (verbose_json if requested, json otherwise), anything else a
+ * 404 with the error body of the real service. Throttling (429 with the
+ * retry-after headers), slow responses and authentication failures can be
+ * injected, so that the whole request path of the devices can be tested and
+ * benchmarked without network access.
+ *
+ * Each connection is served by its own thread, connections are kept alive.
+ */
+class MockAzureOpenAIServer
+{
+public:
+    explicit MockAzureOpenAIServer(const MockServerOptions& options = {});
+    MockAzureOpenAIServer(const MockAzureOpenAIServer&) = delete;
+    MockAzureOpenAIServer(MockAzureOpenAIServer&&) noexcept = delete;
+    MockAzureOpenAIServer& operator=(const MockAzureOpenAIServer&) = delete;
+    MockAzureOpenAIServer& operator=(MockAzureOpenAIServer&&) noexcept = delete;
+    ~MockAzureOpenAIServer();
+
+    /**
+     * Bind the socket and start serving.
+     */
+    bool open();
+
+    /**
+     * Stop serving and wait for all the connections to be closed.
+     */
+    void close();
+
+    /**
+     * The port the server listens on, valid after open().
+     */
+    int port() const;
+
+    /**
+     * The value of the endpoint environment variable of the devices, e.g. http://127.0.0.1:8080
+     */
+    std::string endpoint() const;
+
+    /**
+     * Change the behaviour of the server, the address and the port are ignored.
+     */
+    void setOptions(const MockServerOptions& options);
+
+    /**
+     * Answer the next \p count requests with a 429.
+     */
+    void throttleNext(int count);
+
+    MockServerStats stats() const;
+
+private:
+    struct Response
+    {
+        int status{200};
+        std::string reason{"OK"};
+        std::vector<std::string> headers{"Content-Type: application/json"};
+        std::string body;
+        bool delayed{true};
+    };
+
+    void _handle(const LocalHttpRequest& request, LocalHttpResponder& responder);
+    Response _respond(const LocalHttpRequest& request);
+
+    static Response _error(int status, const std::string& reason, const std::string& code, const std::string& message);
+
+    MockServerOptions m_options;
+    std::string m_speech;
+    int m_throttleNext{0};
+    size_t m_apiRequests{0};
+    MockServerStats m_stats;
+    mutable std::mutex m_mutex;
+    LocalHttpServer m_server;
+};
+
+} // namespace azureopenai
+
+#endif // AZUREOPENAI_MOCKAZUREOPENAISERVER_H
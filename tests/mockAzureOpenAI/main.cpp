@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "MockAzureOpenAIServer.h"
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+volatile std::sig_atomic_t interrupted = 0;
+
+void onSignal(int)
+{
+    interrupted = 1;
+}
+
+void printHelp()
+{
+    std::cout << "Usage: azureOpenAIMockServer [options]\n"
+                 "  --host <address>               address to listen on (default 127.0.0.1)\n"
+                 "  --port <port>                  port to listen on, 0 for a free one (default 8080)\n"
+                 "  --latency <s>                  delay before each response (default 0)\n"
+                 "  --bandwidth <bytes/s>          upload speed of the response bodies, 0 for unlimited (default 0)\n"
+                 "  --speech_file <file>           MP3 served by /audio/speech (default a silent one)\n"
+                 "  --speech_duration <s>          duration of the silent MP3 (default 3)\n"
+                 "  --transcription <text>         text of the transcriptions (default \"Hello world\")\n"
+                 "  --throttle_first <n>           answer the first n requests with a 429 (default 0)\n"
+                 "  --throttle_every <n>           answer one request out of n with a 429 (default 0)\n"
+                 "  --retry_after_ms <ms>          retry-after-ms of the 429 responses (default 100)\n"
+                 "  --api_key <key>                if set, reject the requests with a different api-key\n";
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    yarp::os::Property config;
+    config.fromCommand(argc, argv);
+    if (config.check("help")) {
+        printHelp();
+        return 0;
+    }
+
+    azureopenai::MockServerOptions options;
+    options.host = config.check("host", yarp::os::Value(options.host)).asString();
+    options.port = config.check("port", yarp::os::Value(8080)).asInt32();
+    options.latency = config.check("latency", yarp::os::Value(options.latency)).asFloat64();
+    options.bandwidth = config.check("bandwidth", yarp::os::Value(options.bandwidth)).asFloat64();
+    options.speechDuration = config.check("speech_duration", yarp::os::Value(options.speechDuration)).asFloat64();
+    options.transcription = config.check("transcription", yarp::os::Value(options.transcription)).asString();
+    options.throttleFirst = config.check("throttle_first", yarp::os::Value(options.throttleFirst)).asInt32();
+    options.throttleEvery = config.check("throttle_every", yarp::os::Value(options.throttleEvery)).asInt32();
+    options.retryAfterMs = config.check("retry_after_ms", yarp::os::Value(options.retryAfterMs)).asInt32();
+    options.apiKey = config.check("api_key", yarp::os::Value("")).asString();
+    if (config.check("speech_file")) {
+        std::ifstream file(config.find("speech_file").asString(), std::ios::binary);
+        if (!file) {
+            std::cerr << "Unable to read " << config.find("speech_file").asString() << std::endl;
+            return 1;
+        }
+        options.speech.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    azureopenai::MockAzureOpenAIServer server(options);
+    if (!server.open()) {
+        return 1;
+    }
+    std::cout << "export AZURE_ENDPOINT=" << server.endpoint() << std::endl;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    while (interrupted == 0) {
+        yarp::os::Time::delay(0.1);
+    }
+    server.close();
+
+    azureopenai::MockServerStats stats = server.stats();
+    std::cout << "connections: " << stats.connections
+              << ", speech: " << stats.speech
+              << ", transcriptions: " << stats.transcriptions
+              << ", throttled: " << stats.throttled
+              << ", rejected: " << stats.rejected << std::endl;
+    return 0;
+}